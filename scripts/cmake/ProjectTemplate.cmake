@@ -8,6 +8,7 @@ macro(project_template)
     include(${C74_MIN_API_DIR}/script/min-pretarget.cmake)
 
     set(THULR_PATH ${CMAKE_CURRENT_SOURCE_DIR}/../../thulr/source)
+    set(SHARED_PATH ${CMAKE_CURRENT_SOURCE_DIR}/../../shared)
     
     # Debug info for GitHub Actions
     message(STATUS "=== Configuring ${PROJECT_NAME} ===")
@@ -18,6 +19,7 @@ macro(project_template)
 
     include_directories( 
         ${THULR_PATH}
+        ${SHARED_PATH}
         ${CMAKE_CURRENT_SOURCE_DIR}
     )
 
@@ -70,6 +72,7 @@ macro(project_template)
         ${THULR_PARENT_PATH}
         ${THULR_PATH}
         ${THULR_PATH}/Utils
+        ${SHARED_PATH}
     )
 
     # Apply to all targets
@@ -116,6 +119,27 @@ macro(project_template)
         
         # Add include directories for test executable
         target_include_directories(${PROJECT_NAME}_test PRIVATE ${ALL_INCLUDE_PATHS})
+
+        # The [stress] test cases are hidden from the normal test run.
+        if(SEIDR_STRESS_TESTS)
+            file(READ ${CMAKE_CURRENT_SOURCE_DIR}/${PROJECT_NAME}_test.cpp TEST_SOURCE)
+            string(FIND "${TEST_SOURCE}" "[.stress]" HAS_STRESS_TESTS)
+
+            if(NOT HAS_STRESS_TESTS EQUAL -1)
+                add_test(NAME ${PROJECT_NAME}_stress COMMAND ${PROJECT_NAME}_test "[stress]")
+                set_tests_properties(${PROJECT_NAME}_stress PROPERTIES ENVIRONMENT "TSAN_OPTIONS=halt_on_error=0 second_deadlock_stack=1")
+            endif()
+        endif()
+
+        # So are the [benchmark] test cases.
+        if(SEIDR_BENCHMARKS)
+            file(READ ${CMAKE_CURRENT_SOURCE_DIR}/${PROJECT_NAME}_test.cpp TEST_SOURCE)
+            string(FIND "${TEST_SOURCE}" "[.benchmark]" HAS_BENCHMARKS)
+
+            if(NOT HAS_BENCHMARKS EQUAL -1)
+                add_test(NAME ${PROJECT_NAME}_benchmark COMMAND ${PROJECT_NAME}_test "[benchmark]")
+            endif()
+        endif()
     endif()
 
     #############################################################
@@ -5,39 +5,75 @@
 ///             found in the License.md file.
 
 #include "seidr.BinaryCounter.hpp"
+#include <algorithm>
+#include <limits>
 
 BinaryCounterMax::BinaryCounterMax(const atoms &args) {
     if (!args.empty()) {
-        this->stepCount = args[0];
+        this->stepCount = static_cast<uint8_t>(std::clamp(static_cast<int>(args[0]), 0, UINT8_MAX));
     }
 
     // Create outputs
-    for (int i = 0; i < this->stepCount; i++) {
-        outputs.push_back(
-            std::make_unique<outlet<>>(this, "(anything) output bit " + std::to_string(i)));
-    }
+    static OutletNames names("(anything) output bit ");
+    this->outputs.create(this, this->stepCount, names);
+
+    // 2^(steps - 1) values. AtomicCounter::LIMIT is one short of 2^FIELD_BITS,
+    // so the largest power of two a counter can hold is 2^(FIELD_BITS - 1).
+    int shift = std::clamp(this->stepCount - 1, 0, static_cast<int>(AtomicCounter::FIELD_BITS) - 1);
+    this->counter_.setMaxValue(static_cast<int>(1U << static_cast<unsigned>(shift)));
 
-    int maxValue = (int) std::pow(2, this->stepCount - 1);
-    this->counter_ = Counter(maxValue);
+    // State saved with the patcher.
+    StateSnapshot::load(this->state(), this->slots_, [this](StateReader &reader) { return this->restore(reader); });
 
     updateOutputs();
 }
 
+auto BinaryCounterMax::snapshot() -> std::vector<uint8_t> {
+    StateWriter writer(STATE_VERSION);
+    writer.write(this->counter_.load());
+    writer.write(this->bangEnabled);
+    return std::move(writer.bytes());
+}
+
+auto BinaryCounterMax::restore(StateReader &reader) -> bool {
+    AtomicCounter::State counter {};
+    bool bangEnabled = false;
+
+    if ((reader.version() != STATE_VERSION) || !reader.read(counter) || !reader.read(bangEnabled)) {
+        return false;
+    }
+
+    this->counter_.restore(counter);
+    this->bangEnabled = bangEnabled;
+    return true;
+}
+
+auto BinaryCounterMax::recallSlot(int slot) -> bool {
+    return this->slots_.recall(slot, [this](StateReader &reader) { return this->restore(reader); });
+}
+
 auto BinaryCounterMax::getBit(int output) -> unsigned int {
     return ((this->counter_.value()) >> output) & 0x1;
 }
 
 void BinaryCounterMax::updateOutputs() {
-    // Send data to all outputs
-    for (int i = 0; i < OUTPUT_COUNT; i++) {
-        int current = OUTPUT_COUNT - i - 1;
+    // Read the counter once so every output shows the same value.
+    unsigned int value = this->counter_.value();
+
+    // Send data to all outputs, the last outlet has the lowest bit. Outlets
+    // past the width of the value are always 0.
+    int count = static_cast<int>(this->outputs.size());
+
+    for (int i = 0; i < count; i++) {
+        int current = count - i - 1;
+        unsigned int bit = (i < std::numeric_limits<unsigned int>::digits) ? (value >> i) & 0x1 : 0;
 
         if (this->bangEnabled) {
-            if (this->getBit(i) == 1) {
-                this->outputs[current]->send("bang");
+            if (bit == 1) {
+                this->outputs[current].send("bang");
             }
         } else {
-            this->outputs[current]->send(this->getBit(i));
+            this->outputs[current].send(bit);
         }
     }
 }
@@ -52,6 +88,10 @@ void BinaryCounterMax::disableBangs() {
     this->updateOutputs();
 } */
 
+auto BinaryCounterMax::memoryUsage() const -> size_t {
+    return sizeof(*this) + this->outputs.bytes() + this->slots_.bytes();
+}
+
 auto BinaryCounterMax::counterValue() -> unsigned int {
     return this->counter_.value();
 }
@@ -70,4 +110,27 @@ auto BinaryCounterMax::maxValue() -> unsigned int {
     return this->counter_.getMaxValue();
 }
 
+auto BinaryCounterMax::tick() -> void {
+    this->counter_.tick();
+    this->updateOutputs();
+}
+
+auto BinaryCounterMax::stepBy(int steps) -> void {
+    if (steps <= 0) {
+        return;
+    }
+
+    this->counter_.tick(static_cast<unsigned int>(steps));
+    this->updateOutputs();
+}
+
+auto BinaryCounterMax::locateAt(int position) -> void {
+    if (position < 0) {
+        return;
+    }
+
+    this->counter_.locate(static_cast<unsigned int>(position));
+    this->updateOutputs();
+}
+
 MIN_EXTERNAL(BinaryCounterMax); // NOLINT
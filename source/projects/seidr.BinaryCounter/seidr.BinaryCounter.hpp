@@ -7,11 +7,19 @@
 #pragma once
 
 #include <c74_min.h>
-#include "Counter/Counter.hpp"
+#include "AtomicCounter.hpp"
+#include "ClockFollower.hpp"
+#include "InternalClock.hpp"
+#include "OutletArray.hpp"
+#include "StateSnapshot.hpp"
 
 using namespace c74::min;
 
 class BinaryCounterMax : public object<BinaryCounterMax> {
+private:
+    InternalClock clock_ {this, [this] { return static_cast<double>(this->interval.get()); }, [this] { this->tick(); }};
+    ClockFollower follower_ {this, [this] { this->tick(); }};
+
 public:
     MIN_DESCRIPTION{"Binary Counter"}; // NOLINT 
     MIN_TAGS{"seidr"};                 // NOLINT 
@@ -19,11 +27,18 @@ public:
     MIN_RELATED{"seidr.*"};            // NOLINT 
     
     enum : std::uint8_t {
-        OUTPUT_COUNT = 8
+        OUTPUT_COUNT = 8,
+        STATE_VERSION = 1
     };
 
     explicit BinaryCounterMax(const atoms &args = {});
 
+    // Stops following before the timers go, the clock can wake it until then.
+    ~BinaryCounterMax() { this->follower_.follow(""); }
+
+    BinaryCounterMax(const BinaryCounterMax &) = delete;
+    auto operator=(const BinaryCounterMax &) -> BinaryCounterMax & = delete;
+
     auto updateOutputs() -> void;
     auto getBit(int output) -> unsigned int;
 
@@ -31,12 +46,23 @@ public:
     auto setPreset(unsigned int presetValue) -> unsigned int;
     auto preset() -> unsigned int;
     auto maxValue() -> unsigned int;
+    auto stepBy(int steps) -> void;
+    auto locateAt(int position) -> void;
+    auto tick() -> void;
+    auto followClock() -> int { return this->follower_.drain(); }
+    auto lastTick() const -> const Tick & { return this->follower_.lastTick(); }
     auto getStepCount() const -> int { return this->stepCount; };
+    auto memoryUsage() const -> size_t;
+
+    // State snapshots.
+    auto snapshot() -> std::vector<uint8_t>;
+    auto restore(StateReader &reader) -> bool;
+    auto recallSlot(int slot) -> bool;
 
     inlet<> input0 {this, "(bang | list | reset) input pulse"};
     inlet<> input1 {this, "(int | reset) reset pulse"};
 
-    std::vector<std::unique_ptr<outlet<>>> outputs;
+    OutletArray<> outputs;
 
     message<threadsafe::yes> bang {
         this, "bang", "Steps the counter.",
@@ -44,29 +70,45 @@ public:
             switch(inlet){
                 case 1:
                     this->counter_.reset();
-                    this->alreadyBanged = false;
-
                     break;
                 default:
-                    if (this->alreadyBanged){
-                        this->counter_.step();
-                    } else {
-                        this->alreadyBanged = true;
-                    }
-                    this->updateOutputs();
+                    this->tick();
                     break;
             }
             return {};
         }
     };
 
+    attribute<time_value> interval {this, "interval", 0.0,
+        description{"Step on an internal clock every interval, in ms or a note value. 0 turns the clock off."},
+        setter{
+            MIN_FUNCTION{
+                this->clock_.changed();
+                return args;
+            }
+        }
+    };
+
+    attribute<symbol> clock_name {this, "clock", "",
+        description{"Step on the ticks of the seidr.Clock~ with this name. Empty stops following."},
+        setter{
+            MIN_FUNCTION{
+                std::string name = args[0];
+
+                if (!this->follower_.follow(name)) {
+                    c74::max::object_error((c74::max::t_object*) this, "too many objects follow %s", name.c_str());
+                }
+                return args;
+            }
+        }
+    };
+
     message<threadsafe::yes> reset {
         this, "reset", "Reset the counter.",
         MIN_FUNCTION{
             switch(inlet){
                 case 1:
                     this->counter_.reset();
-                    this->alreadyBanged = false;
                     break;
                 default:
                     break;
@@ -96,6 +138,26 @@ public:
         }
     };
 
+    message<threadsafe::yes> step_msg {
+        this, "step", "Step the counter n times and output only the result.",
+        MIN_FUNCTION{
+            if (!args.empty()) {
+                this->stepBy(args[0]);
+            }
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> locate_msg {
+        this, "locate", "Go to the value n steps after a reset.",
+        MIN_FUNCTION{
+            if (!args.empty()) {
+                this->locateAt(args[0]);
+            }
+            return {};
+        }
+    };
+
     message<threadsafe::yes> max_value {this, "max", "Set the counter max value.",
         MIN_FUNCTION{
             if(!args.empty()){
@@ -105,6 +167,41 @@ public:
         }
     };
 
+    message<threadsafe::yes> memory {this, "memory", "Post the number of bytes used by this instance.",
+        MIN_FUNCTION{
+            c74::max::object_post((c74::max::t_object*) this, "%zu bytes", this->memoryUsage());
+            return {};
+        }
+    };
+
+    message<> store {this, "store", "Store the state in a slot (0-15).",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                this->slots_.store(static_cast<int> (args[0]), this->snapshot());
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> recall {this, "recall", "Recall the state stored in a slot (0-15).",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                this->recallSlot(static_cast<int> (args[0]));
+            }
+
+            return {};
+        }
+    };
+
+    message<> savestate {this, "savestate", "Save the state and the slots with the patcher.",
+        MIN_FUNCTION{
+            dict state {args[0]};
+            StateSnapshot::save(state, this->snapshot(), this->slots_);
+            return {};
+        }
+    };
+
     message<threadsafe::yes> bangEnable {this, "bangEnable", "Enable bang outputs.",
         MIN_FUNCTION{
             this->bangEnabled = true;
@@ -120,8 +217,9 @@ public:
     };
 
 private:
-    Counter counter_;
-    int stepCount = OUTPUT_COUNT;
+    AtomicCounter counter_;
+    uint8_t stepCount = OUTPUT_COUNT;
     bool bangEnabled = false;
-    bool alreadyBanged = false;
+
+    StateSlots<> slots_;
 };
@@ -7,6 +7,9 @@
 #include "seidr.BinaryCounter.cpp" // NOLINT
 #include "seidr.BinaryCounter.hpp"
 #include <c74_min_unittest.h>
+#include "InstantiationBenchmark.hpp"
+#include "StressRunner.hpp"
+#include <iostream>
 
 using namespace c74::max;
 
@@ -152,3 +155,160 @@ SCENARIO("enable bangs works") { // NOLINT
         }
     }
 }
+
+SCENARIO("a wide counter counts a power of two") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("more steps than a counter field has bits") {
+        BinaryCounterMax wide(atoms { 32 }); // NOLINT
+
+        THEN("the counter counts the largest power of two it can hold") {
+            REQUIRE(wide.maxValue() == (1U << (AtomicCounter::FIELD_BITS - 1)));
+            REQUIRE(wide.maxValue() <= AtomicCounter::LIMIT);
+        }
+    }
+}
+
+SCENARIO("every outlet shows one bit of the value") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("counters with fewer and more steps than the default") {
+        BinaryCounterMax narrow(atoms { 4 }); // NOLINT
+        BinaryCounterMax wide(atoms { 40 }); // NOLINT
+
+        narrow.locate_msg({ 5 }, 0); // NOLINT
+        wide.locate_msg({ 5 }, 0); // NOLINT
+
+        THEN("the last outlet has the lowest bit") {
+            for (int i = 0; i < 4; i++) {
+                auto &out = *object_getoutput(narrow, 3 - i);
+                REQUIRE(out.size() == 2);
+                REQUIRE(static_cast<int>(out.back()[0]) == ((5 >> i) & 0x1)); // NOLINT
+            }
+        }
+
+        THEN("every outlet of the wide counter is sent") {
+            for (int i = 0; i < 40; i++) { // NOLINT
+                auto &out = *object_getoutput(wide, 39 - i); // NOLINT
+                REQUIRE(out.size() == 2);
+                REQUIRE(static_cast<int>(out.back()[0]) == ((i < 3) ? ((5 >> i) & 0x1) : 0)); // NOLINT
+            }
+        }
+    }
+}
+
+SCENARIO("object jumps ahead") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("two instances of our object") {
+        test_wrapper<BinaryCounterMax> stepped_instance;
+        test_wrapper<BinaryCounterMax> jumped_instance;
+        BinaryCounterMax &stepped = stepped_instance;
+        BinaryCounterMax &jumped = jumped_instance;
+
+        WHEN("one is banged and the other is stepped in one message") {
+            for (int i = 0; i < 300; i++) { // NOLINT
+                stepped.bang(0);
+            }
+
+            jumped.step_msg({ 300 }, 0); // NOLINT
+
+            THEN("they end on the same value") {
+                REQUIRE(jumped.counterValue() == stepped.counterValue());
+            }
+        }
+
+        WHEN("the preset is set before the jump") {
+            jumped.preset_msg({ 3 }, 1); // NOLINT
+            jumped.step_msg({ 10 }, 0); // NOLINT
+            jumped.preset_msg(emptyAtoms, 1);
+
+            THEN("the preset is kept") {
+                REQUIRE(jumped.counterValue() == 3);
+            }
+        }
+
+        WHEN("the counter is located") {
+            jumped.locate_msg({ 5 }, 0); // NOLINT
+
+            THEN("it is on that value") {
+                REQUIRE(jumped.counterValue() == 5);
+            }
+        }
+
+        WHEN("step and locate arrive at the reset inlet") {
+            jumped.locate_msg({ 5 }, 1); // NOLINT
+            jumped.step_msg({ 2 }, 1); // NOLINT
+
+            THEN("they are handled like at the first inlet, as in seidr.NCounter") {
+                REQUIRE(jumped.counterValue() == 7);
+            }
+        }
+    }
+}
+
+SCENARIO("BinaryCounterMax under concurrent messages", "[.stress]") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<BinaryCounterMax> an_instance;
+    BinaryCounterMax &myObject = an_instance;
+
+    // Every output is a bang or the state of a step.
+    uint64_t sent = 0;
+    uint64_t invalid = 0;
+
+    auto drain = [&] {
+        for (int i = 0; i < BinaryCounterMax::OUTPUT_COUNT; i++) {
+            auto &out = *object_getoutput(myObject, i);
+
+            for (const auto &entry : out) {
+                const auto &value = entry.back();
+                bool isBang = value.type() == c74::min::message_type::symbol_argument;
+                invalid += (isBang || (static_cast<int>(value) == 0) || (static_cast<int>(value) == 1)) ? 0 : 1;
+            }
+
+            sent += out.size();
+            out.clear();
+        }
+    };
+
+    StressRunner stress(100000); // NOLINT
+
+    stress.scheduler("bang", [&](uint64_t) { myObject.bang(); }, drain);
+
+    stress.main("max", [&](uint64_t n) {
+        myObject.max_value(static_cast<int>(n % 255) + 1); // NOLINT
+    });
+
+    stress.main("preset", [&](uint64_t n) {
+        myObject.preset_msg(static_cast<int>(n % 16), 1); // NOLINT
+        myObject.preset_msg(emptyAtoms, 1);
+    });
+
+    StressRunner::report("seidr.BinaryCounter", stress.run(), std::cout);
+
+    THEN("every output is a bang or a step state and the state can be read") {
+        REQUIRE(sent > 0);
+        REQUIRE(invalid == 0);
+
+        std::vector<uint8_t> state = myObject.snapshot();
+        StateReader reader(state);
+
+        REQUIRE(reader.isValid());
+        REQUIRE(myObject.restore(reader));
+    }
+}
+
+SCENARIO("BinaryCounterMax instantiation cost", "[.benchmark]") { // NOLINT
+    ext_main(nullptr);
+
+    auto result = InstantiationBenchmark::run<test_wrapper<BinaryCounterMax>>(10000); // NOLINT
+    InstantiationBenchmark::report("seidr.BinaryCounter", result, std::cout);
+
+    THEN("every object was created and each one after the first costs the same") {
+        REQUIRE(result.count == 10000); // NOLINT
+        REQUIRE(result.lastAllocations > 0);
+        REQUIRE(result.lastAllocations < result.firstAllocations);
+        REQUIRE(result.allocations == Approx(result.lastAllocations).margin(0.01)); // NOLINT
+    }
+}
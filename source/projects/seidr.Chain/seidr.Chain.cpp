@@ -0,0 +1,136 @@
+/// @file       seidr.Chain.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.Chain.hpp"
+#include "Utils/MIDI.hpp"
+#include <algorithm>
+
+using namespace c74;
+
+ChainMax::ChainMax(const min::atoms &args) {
+    // Default octave range
+    int low = MIDI::RANGE_LOW;
+    int high = MIDI::RANGE_HIGH;
+
+    if (args.size() >= 2) {
+        low = std::clamp(static_cast<int> (args[0]), MIDI::RANGE_LOW, MIDI::RANGE_HIGH);
+        high = std::clamp(static_cast<int> (args[1]), MIDI::RANGE_LOW, MIDI::RANGE_HIGH);
+
+        if (low > high) {
+            std::swap(low, high);
+        }
+    }
+
+    this->setOctaveRange(low, high);
+}
+
+auto ChainMax::setWeights(const min::atoms &weights) -> void {
+    if (weights.empty()) {
+        this->octaves_.clearWeights();
+        return;
+    }
+
+    std::vector<double> values;
+    values.reserve(weights.size());
+
+    for (const auto &weight : weights) {
+        values.push_back(static_cast<double>(weight));
+    }
+
+    this->octaves_.setWeights(values);
+}
+
+auto ChainMax::memoryUsage() const -> size_t {
+    return sizeof(*this) + (this->octaves_.weights().capacity() * sizeof(double));
+}
+
+auto ChainMax::setPolyphony(int polyphony) -> void {
+    this->notes_.setPolyphony(polyphony);
+
+    // Turn off the oldest notes above the new limit.
+    NoteIndex::Note stolen {};
+
+    while ((this->notes_.size() > this->notes_.getPolyphony()) && this->notes_.steal(stolen)) {
+        output_note.send({ stolen.pitch, 0 });
+    }
+}
+
+auto ChainMax::queueNote(int pitch, int velocity) -> void {
+    this->queue_[this->queueSize_++] = {0, static_cast<uint8_t>(pitch), static_cast<uint8_t>(velocity), -1};
+}
+
+auto ChainMax::queueRelease(int note) -> void {
+    NoteIndex::Entry released = this->notes_.release(note);
+
+    for (int slot = 0; slot < released.count; slot++) {
+        this->queueNote(released.pitch[slot], 0);
+    }
+}
+
+auto ChainMax::sendQueue() -> void {
+    for (int i = 0; i < this->queueSize_; i++) {
+        output_note.send({ this->queue_[i].pitch, this->queue_[i].velocity });
+    }
+
+    this->queueSize_ = 0;
+}
+
+auto ChainMax::clearNoteMessage(int note) -> void {
+    if ((note < MIDI::RANGE_LOW) || (note > MIDI::RANGE_HIGH)) {
+        return;
+    }
+
+    this->queueRelease(note);
+    this->sendQueue();
+}
+
+auto ChainMax::clearAllNotesMessage() -> void {
+    // Send all notes off as fallback.
+    this->notes_.clear();
+
+    for (int note = 0; note < MIDI::KEYBOARD_SIZE; note++) {
+        output_note.send({note, 0});
+    }
+}
+
+auto ChainMax::processNoteMessage(int note, int velocity) -> void { // NOLINT
+    // Validate input.
+    if ((note < MIDI::RANGE_LOW) || (note > MIDI::RANGE_HIGH) || (velocity < 0) || (velocity > MIDI::RANGE_HIGH)) {
+        return;
+    }
+
+    // Notes are kept by the incoming note, so a note off turns off what was
+    // sent for it even if the scale has changed since.
+    if (velocity == 0) {
+        this->queueRelease(note);
+        this->sendQueue();
+        return;
+    }
+
+    int quantized = this->quantizer_.quantize(MIDI::Note(note));
+
+    if ((quantized < MIDI::RANGE_LOW) || (quantized > MIDI::RANGE_HIGH)) {
+        return;
+    }
+
+    int pitch = this->octaves_.pick(quantized % MIDI::OCTAVE);
+
+    // The pitch class is not in the octave range.
+    if (pitch < 0) {
+        pitch = quantized;
+    }
+
+    NoteIndex::Note evicted {};
+
+    if (this->notes_.add(note, pitch, velocity, evicted)) {
+        this->queueNote(evicted.pitch, 0);
+    }
+
+    this->queueNote(pitch, velocity);
+    this->sendQueue();
+}
+
+MIN_EXTERNAL(ChainMax); // NOLINT
@@ -0,0 +1,272 @@
+/// @file       seidr.Chain.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "MessageArgs.hpp"
+#include "NoteIndex.hpp"
+#include "OctaveDistribution.hpp"
+#include "Quantizer/Quantizer.hpp"
+#include <array>
+#include <c74_min.h>
+
+using namespace c74;
+
+class ChainMax : public min::object<ChainMax> {
+private:
+    Quantizer quantizer_;
+    OctaveDistribution octaves_;
+    NoteIndex notes_;
+
+    // Notes waiting to be sent for the current message.
+    std::array<NoteIndex::Note, 2 * NoteIndex::SLOTS> queue_ = {};
+    int queueSize_ = 0;
+
+    auto queueNote(int pitch, int velocity) -> void;
+    auto queueRelease(int note) -> void;
+    auto sendQueue() -> void;
+
+public:
+    MIN_DESCRIPTION{"Quantize a MIDI note and randomize its octave."}; // NOLINT
+    MIN_TAGS{"seidr"};                                                 // NOLINT
+    MIN_AUTHOR{"Jóhann Berentsson"};                                   // NOLINT
+    MIN_RELATED{"seidr.*"};                                            // NOLINT
+
+    enum Inlets : uint8_t {
+        NOTE = 0,
+        ARGS = 1
+    };
+
+    using RoundDirection = Quantizer::RoundDirection;
+    using QuantizeMode = Quantizer::QuantizeMode;
+    using NoteThrough = Quantizer::NoteThrough;
+
+    explicit ChainMax(const min::atoms &args = {});
+
+    auto processNoteMessage(int note, int velocity) -> void;
+    auto clearAllNotesMessage() -> void;
+    auto clearNoteMessage(int note) -> void;
+    auto setOctaveRange(int low, int high) -> void { this->octaves_.setRange(low, high); }
+    auto setWeights(const min::atoms &weights) -> void;
+    auto setPolyphony(int polyphony) -> void;
+    auto getPolyphony() const -> int { return this->notes_.getPolyphony(); }
+    auto noteCount() -> int { return this->quantizer_.noteCount(); }
+    auto getActiveNotes() const -> std::vector<NoteIndex::Note> { return this->notes_.notes(); }
+    auto memoryUsage() const -> size_t;
+
+    // Inlets
+    min::inlet<> input_note       {this, "(list) note, velocity"};
+    min::inlet<> input_arguments  {this, "(add|delete|update|mode|round|through|range|octaves|weights|polyphony|clear|memory) arguments"};
+
+    // Outlets
+    min::outlet<> output_note     {this, "(list) pitch, velocity"};
+
+    min::message<min::threadsafe::yes> anything {
+        this, "anything", "Handle any input",
+        MIN_FUNCTION {
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> list {
+        this, "list", "Process note messages",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::NOTE && args.size() >= 2) {
+                int note = static_cast<int> (args[0]);
+                int velocity = static_cast<int> (args[1]);
+                this->processNoteMessage(note, velocity);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerAddNote {
+        this, "add", "Add notes to the quantizer",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS) {
+                for (const auto &arg : args) {
+                    int note = 0;
+                    if (MessageArgs::readNote(arg, note)) {
+                        this->quantizer_.addNote(MIDI::Note(note));
+                    }
+                }
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerDeleteNote {
+        this, "delete", "Delete notes from the quantizer",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS) {
+                for (const auto &arg : args) {
+                    int note = 0;
+                    if (MessageArgs::readNote(arg, note)) {
+                        this->quantizer_.deleteNote(MIDI::Note(note));
+                    }
+                }
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> updateNotes {
+        this, "update", "Replace the notes of the quantizer, no arguments clears them",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS) {
+                this->quantizer_.clear();
+
+                for (const auto &arg : args) {
+                    int note = 0;
+                    if (MessageArgs::readNote(arg, note)) {
+                        this->quantizer_.addNote(MIDI::Note(note));
+                    }
+                }
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerMode {
+        this, "mode", "Set quantizer mode.",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int mode = 0;
+
+                if (!MessageArgs::readInt(args[0], mode) || (mode < static_cast<int>(QuantizeMode::ALL_NOTES)) || (mode > static_cast<int>(QuantizeMode::TWELVE_NOTES))) {
+                    max::object_error((max::t_object*) this, "mode needs 0 or 1");
+                    return {};
+                }
+
+                this->quantizer_.setMode(QuantizeMode(mode));
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerRound {
+        this, "round", "Set quantizer round direction.",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int direction = 0;
+
+                if (!MessageArgs::readInt(args[0], direction) || (direction < static_cast<int>(RoundDirection::UP)) || (direction > static_cast<int>(RoundDirection::FURTHEST))) {
+                    max::object_error((max::t_object*) this, "round needs a rounding mode 0-7");
+                    return {};
+                }
+
+                this->quantizer_.setRoundDirection(RoundDirection(direction));
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerThrough {
+        this, "through", "Disable note through.",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int through = 0;
+
+                if (!MessageArgs::readInt(args[0], through) || (through < static_cast<int>(NoteThrough::OFF)) || (through > static_cast<int>(NoteThrough::ON))) {
+                    max::object_error((max::t_object*) this, "through needs 0 or 1");
+                    return {};
+                }
+
+                this->quantizer_.setThrough(NoteThrough(through));
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerRange {
+        this, "range", "Set quantizer range.",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int low = 0;
+                int high = 0;
+
+                if ((args.size() < 2) || !MessageArgs::readNote(args[0], low) || !MessageArgs::readNote(args[1], high)) {
+                    max::object_error((max::t_object*) this, "range needs a low and a high note");
+                    return {};
+                }
+
+                this->quantizer_.setRange(MIDI::Note(low), MIDI::Note(high));
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> octaves {
+        this, "octaves", "Set the range the octaves are picked from",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int low = 0;
+                int high = 0;
+
+                if (!MessageArgs::readInts(args, low, high)) {
+                    max::object_error((max::t_object*) this, "octaves needs a low and a high note");
+                    return {};
+                }
+
+                this->setOctaveRange(low, high);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> weights {
+        this, "weights", "Set the weight of each octave in the range, no arguments for an even spread",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS) {
+                this->setWeights(args);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> polyphony {
+        this, "polyphony", "Set the number of notes that can play at once, the oldest note is stolen when it is reached",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int voices = 0;
+
+                if (!MessageArgs::readInt(args[0], voices)) {
+                    max::object_error((max::t_object*) this, "polyphony needs a number of notes");
+                    return {};
+                }
+
+                this->setPolyphony(voices);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> clear {
+        this, "clear", "Turn off a note, or every note with all",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int note = 0;
+
+                if (MessageArgs::isSymbol(args[0], MessageArgs::ALL)) {
+                    this->clearAllNotesMessage();
+                } else if (MessageArgs::readNote(args[0], note)) {
+                    this->clearNoteMessage(note);
+                } else {
+                    max::object_error((max::t_object*) this, "clear needs all, a note number or a note name");
+                }
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> memory {
+        this, "memory", "Post the number of bytes used by this instance",
+        MIN_FUNCTION {
+            max::object_post((max::t_object*) this, "%zu bytes", this->memoryUsage());
+            return {};
+        }
+    };
+};
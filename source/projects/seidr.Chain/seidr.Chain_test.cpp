@@ -0,0 +1,75 @@
+/// @file       seidr.Chain_test.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "c74_min_unittest.h"
+#include "seidr.Chain.cpp" // NOLINT
+#include "seidr.Chain.hpp"
+#include "Utils/MIDI.hpp"
+
+using namespace c74;
+using namespace MIDI::Notes;
+using Inlets = ChainMax::Inlets;
+
+SCENARIO("seidr.Chain quantizes and randomizes the octave in one step") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<ChainMax> an_instance;
+    ChainMax &chain = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(chain, 0);
+
+    GIVEN("a C major triad and a two octave range") {
+        REQUIRE_NOTHROW(chain.updateNotes({ NoteC4, NoteE4, NoteG4 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(chain.octaves({ NoteC4, NoteC6 - 1 }, Inlets::ARGS));
+        REQUIRE(chain.noteCount() == 3);
+
+        WHEN("notes are played and released") {
+            for (int note = NoteC4; note < NoteC5; note++) {
+                REQUIRE_NOTHROW(chain.list({ note, 100 }, Inlets::NOTE));
+            }
+
+            THEN("every note is inside the octave range") {
+                REQUIRE(note_output.size() == 12);
+
+                for (const auto &output : note_output) {
+                    REQUIRE(static_cast<int>(output[0]) >= NoteC4);
+                    REQUIRE(static_cast<int>(output[0]) < NoteC6);
+                    REQUIRE(output[1] == 100);
+                }
+
+                REQUIRE(chain.getActiveNotes().size() == 12);
+            }
+
+            THEN("each note off turns off what was sent for it") {
+                for (int note = NoteC4; note < NoteC5; note++) {
+                    REQUIRE_NOTHROW(chain.list({ note, 0 }, Inlets::NOTE));
+                    REQUIRE(note_output.back()[0] == note_output[note - NoteC4][0]);
+                    REQUIRE(note_output.back()[1] == 0);
+                }
+
+                REQUIRE(chain.getActiveNotes().empty());
+            }
+        }
+
+        WHEN("every note is cleared") {
+            REQUIRE_NOTHROW(chain.list({ NoteC4, 100 }, Inlets::NOTE));
+            REQUIRE_NOTHROW(chain.clear({ "all" }, Inlets::ARGS));
+
+            THEN("nothing is left playing") {
+                REQUIRE(chain.getActiveNotes().empty());
+            }
+        }
+
+        WHEN("octave weights are set") {
+            REQUIRE_NOTHROW(chain.weights({ 1, 2, 3 }, Inlets::ARGS));
+
+            THEN("the memory used counts them") {
+                REQUIRE(chain.memoryUsage() >= sizeof(ChainMax) + (3 * sizeof(double)));
+                REQUIRE_NOTHROW(chain.memory());
+            }
+        }
+    }
+}
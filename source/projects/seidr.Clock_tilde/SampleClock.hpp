@@ -0,0 +1,79 @@
+/// @file       SampleClock.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "TickChannel.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// A phase that ramps from 0 to 1 once per period and ticks when it wraps.
+//
+// The clock runs a signal vector at a time and places every tick on its
+// sample, the offset into the vector. It counts whole samples against the
+// period and keeps the fraction of a sample left over at a tick, so ticks
+// don't drift however the period divides into samples. A rising edge on the
+// reset input restarts the clock on that sample and ticks there.
+class SampleClock {
+public:
+    // period is in samples, 0 stops the clock. reset may be null.
+    // onTick(const Tick &) is called on the audio thread for every tick in the
+    // vector, in order.
+    template <typename OnTick>
+    auto process(const double *reset, double *phase, double *ticks, size_t frames, double period, OnTick onTick) -> void {
+        for (size_t i = 0; i < frames; i++) {
+            if (reset != nullptr) {
+                if ((reset[i] > 0.0) && (this->lastReset_ <= 0.0)) {
+                    this->reset();
+                }
+
+                this->lastReset_ = reset[i];
+            }
+
+            bool tick = false;
+
+            if (!this->started_ && ((period > 0.0) || (reset != nullptr && reset[i] > 0.0))) {
+                tick = true;
+                this->started_ = true;
+                this->elapsed_ = 0.0;
+            } else if ((period > 0.0) && (this->elapsed_ >= period)) {
+                // A shorter period can leave more than one period behind.
+                tick = true;
+                this->elapsed_ = std::fmod(this->elapsed_, period);
+            }
+
+            if (tick) {
+                onTick(Tick {this->sample_, this->index_++, static_cast<uint16_t>(i)});
+            }
+
+            phase[i] = (period > 0.0) ? this->elapsed_ / period : 0.0;
+            ticks[i] = tick ? 1.0 : 0.0;
+
+            if (period > 0.0) {
+                this->elapsed_ += 1.0;
+            }
+
+            this->sample_++;
+        }
+    }
+
+    // Start again from the first tick, on the next sample.
+    auto reset() -> void {
+        this->started_ = false;
+        this->index_ = 0;
+    }
+
+    [[nodiscard]] auto sample() const -> uint64_t { return this->sample_; }
+
+private:
+    // Samples since the last tick.
+    double elapsed_ = 0.0;
+    double lastReset_ = 0.0;
+    uint64_t sample_ = 0;
+    uint32_t index_ = 0;
+    bool started_ = false;
+};
@@ -0,0 +1,38 @@
+/// @file       seidr.Clock_tilde.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.Clock_tilde.hpp"
+
+using namespace c74;
+
+ClockMax::ClockMax(const min::atoms &args) {
+    // Interval
+    if (!args.empty()) {
+        this->interval = static_cast<double>(args[0]);
+    }
+}
+
+auto ClockMax::operator()(min::audio_bundle input, min::audio_bundle output) -> void {
+    if (this->resetPending_.exchange(false, std::memory_order_relaxed)) {
+        this->clock_.reset();
+    }
+
+    double interval = this->intervalMs_.load(std::memory_order_relaxed);
+    double period = interval * this->samplerate() / 1000.0; // NOLINT
+
+    this->clock_.process(input.samples(0), output.samples(0), output.samples(1), output.frame_count(), period, [this](const Tick &tick) {
+        this->sender_.send(tick);
+        this->ticks_.push(tick);
+    });
+}
+
+auto ClockMax::sendTicks() -> void {
+    this->ticks_.drain([this](const Tick &tick) {
+        this->output_tick.send(static_cast<long>(tick.index), static_cast<long>(tick.sample));
+    });
+}
+
+MIN_EXTERNAL(ClockMax); // NOLINT
@@ -0,0 +1,96 @@
+/// @file       seidr.Clock_tilde.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "SampleClock.hpp"
+#include "TickChannel.hpp"
+#include <algorithm>
+#include <atomic>
+#include <c74_min.h>
+#include <string>
+
+using namespace c74;
+
+class ClockMax : public min::object<ClockMax>, public min::vector_operator<> {
+private:
+    // Written by the interval and name setters, so they come before them.
+    static constexpr double DEFAULT_INTERVAL = 500.0;
+
+    TickSender sender_;
+    std::atomic<double> intervalMs_ {DEFAULT_INTERVAL};
+
+public:
+    MIN_DESCRIPTION{"Sample accurate master clock for seidr counters and shift registers."}; // NOLINT
+    MIN_TAGS{"seidr"};                                                                      // NOLINT
+    MIN_AUTHOR{"Jóhann Berentsson"};                                                        // NOLINT
+    MIN_RELATED{"seidr.*"};                                                                 // NOLINT
+
+    explicit ClockMax(const min::atoms &args = {});
+
+    auto operator()(min::audio_bundle input, min::audio_bundle output) -> void;
+
+    // Sends the ticks of the last vectors from the message outlet.
+    auto sendTicks() -> void;
+
+    // Inlets
+    min::inlet<> input_reset      {this, "(signal) restart the clock on a rising edge", "signal"};
+
+    // Outlets
+    min::outlet<> output_phase    {this, "(signal) phase from 0 to 1", "signal"};
+    min::outlet<> output_ticks    {this, "(signal) 1 on the sample of each tick", "signal"};
+    min::outlet<> output_tick     {this, "(list) tick number and sample position"};
+
+    min::attribute<min::number> interval {
+        this, "interval", DEFAULT_INTERVAL,
+        min::description{"Milliseconds between ticks, 0 stops the clock."},
+        min::setter{
+            MIN_FUNCTION {
+                this->intervalMs_.store(std::max(0.0, static_cast<double>(args[0])), std::memory_order_relaxed);
+                return args;
+            }
+        }
+    };
+
+    min::attribute<min::symbol> channel_name {
+        this, "name", "",
+        min::description{"Send the ticks to the seidr objects with this @clock name."},
+        min::setter{
+            MIN_FUNCTION {
+                std::string name = args[0];
+
+                if (!this->sender_.setName(name)) {
+                    max::object_error((max::t_object*) this, "another seidr.Clock~ is named %s", name.c_str());
+                    return {min::symbol(this->sender_.name())};
+                }
+
+                return args;
+            }
+        }
+    };
+
+    min::message<min::threadsafe::yes> reset {
+        this, "reset", "Restart the clock at the start of the next signal vector.",
+        MIN_FUNCTION {
+            this->resetPending_.store(true, std::memory_order_relaxed);
+            return {};
+        }
+    };
+
+    min::timer<> tick_timer {
+        this, MIN_FUNCTION {
+            this->sendTicks();
+            return {};
+        }
+    };
+
+private:
+    SampleClock clock_;
+    std::atomic<bool> resetPending_ {false};
+
+    // The clock's own ticks, for the message outlet.
+    TickInbox ticks_ {[this] { this->tick_timer.delay(0); }};
+};
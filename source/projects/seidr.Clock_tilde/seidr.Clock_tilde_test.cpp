@@ -0,0 +1,223 @@
+/// @file       seidr.Clock_tilde_test.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.Clock_tilde.cpp" // NOLINT
+#include "seidr.Clock_tilde.hpp"
+#include <c74_min_unittest.h>
+#include <vector>
+
+using namespace c74::max;
+
+namespace {
+    // Runs the clock for frames samples in vectors of vectorSize and returns
+    // the ticks.
+    auto runClock(SampleClock &clock, size_t frames, size_t vectorSize, double period, const std::vector<double> &reset = {}) -> std::vector<Tick> {
+        std::vector<Tick> ticks;
+        std::vector<double> phase(vectorSize);
+        std::vector<double> pulses(vectorSize);
+
+        for (size_t start = 0; start < frames; start += vectorSize) {
+            const double *resetVector = reset.empty() ? nullptr : reset.data() + start;
+
+            clock.process(resetVector, phase.data(), pulses.data(), vectorSize, period, [&ticks](const Tick &tick) {
+                ticks.push_back(tick);
+            });
+        }
+
+        return ticks;
+    }
+} // namespace
+
+SCENARIO("SampleClock places every tick on its sample") { // NOLINT
+    SampleClock clock;
+
+    WHEN("the period is 10 samples and the vector is 16") {
+        auto ticks = runClock(clock, 64, 16, 10.0); // NOLINT
+
+        THEN("a tick lands every 10 samples at its offset in the vector") {
+            REQUIRE(ticks.size() == 7);
+
+            for (size_t i = 0; i < ticks.size(); i++) {
+                REQUIRE(ticks[i].index == i);
+                REQUIRE(ticks[i].sample == i * 10);
+                REQUIRE(ticks[i].offset == (i * 10) % 16);
+            }
+        }
+    }
+
+    WHEN("the period is not a whole number of samples") {
+        auto ticks = runClock(clock, 1024, 64, 12.5); // NOLINT
+
+        THEN("the left over fraction is kept and the ticks don't drift") {
+            REQUIRE(ticks.size() == 82);
+            REQUIRE(ticks[80].sample == 1000);
+            REQUIRE(ticks[81].sample == 1013);
+        }
+    }
+
+    WHEN("the period is 0") {
+        runClock(clock, 1, 1, 4.0); // NOLINT
+        auto ticks = runClock(clock, 100, 10, 0.0); // NOLINT
+
+        THEN("the clock stops") {
+            REQUIRE(ticks.empty());
+        }
+    }
+}
+
+SCENARIO("SampleClock outputs a phase ramp and tick pulses") { // NOLINT
+    SampleClock clock;
+    std::vector<double> phase(8);
+    std::vector<double> pulses(8);
+
+    clock.process(nullptr, phase.data(), pulses.data(), 8, 4.0, [](const Tick &) {}); // NOLINT
+
+    THEN("the phase ramps from 0 and the pulses mark the wraps") {
+        std::vector<double> expectedPhase = {0.0, 0.25, 0.5, 0.75, 0.0, 0.25, 0.5, 0.75};
+        std::vector<double> expectedPulses = {1.0, 0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0};
+
+        REQUIRE(phase == expectedPhase);
+        REQUIRE(pulses == expectedPulses);
+    }
+}
+
+SCENARIO("SampleClock restarts on a rising edge") { // NOLINT
+    SampleClock clock;
+    std::vector<double> reset(32, 0.0); // NOLINT
+
+    for (size_t i = 13; i < 20; i++) { // NOLINT
+        reset[i] = 1.0;
+    }
+
+    auto ticks = runClock(clock, 32, 8, 10.0, reset); // NOLINT
+
+    THEN("the clock ticks on the edge and counts again from 0") {
+        REQUIRE(ticks.size() == 4);
+        REQUIRE(ticks[1].sample == 10);
+        REQUIRE(ticks[2].sample == 13);
+        REQUIRE(ticks[2].index == 0);
+        REQUIRE(ticks[2].offset == 5);
+        REQUIRE(ticks[3].sample == 23);
+        REQUIRE(ticks[3].index == 1);
+    }
+}
+
+SCENARIO("TickInbox wakes its follower once per batch") { // NOLINT
+    int wakes = 0;
+    TickInbox inbox([&wakes] { wakes++; });
+
+    WHEN("ticks arrive before the follower drains") {
+        for (uint32_t i = 0; i < 5; i++) { // NOLINT
+            inbox.push(Tick {i * 10, i, 0});
+        }
+
+        std::vector<uint32_t> drained;
+        int count = inbox.drain([&drained](const Tick &tick) { drained.push_back(tick.index); });
+
+        THEN("the follower is woken once and gets the ticks in order") {
+            REQUIRE(wakes == 1);
+            REQUIRE(count == 5);
+            REQUIRE(drained == (std::vector<uint32_t> {0, 1, 2, 3, 4}));
+        }
+
+        THEN("a tick after the drain wakes the follower again") {
+            inbox.push(Tick {});
+            REQUIRE(wakes == 2);
+        }
+    }
+
+    WHEN("the inbox is full") {
+        for (uint32_t i = 0; i < TickInbox::CAPACITY + 3; i++) {
+            inbox.push(Tick {i, i, 0});
+        }
+
+        THEN("the ticks that don't fit are dropped and counted") {
+            REQUIRE(inbox.dropped() == 3);
+            REQUIRE(inbox.drain([](const Tick &) {}) == TickInbox::CAPACITY);
+        }
+    }
+}
+
+SCENARIO("TickSender sends to every follower of its channel") { // NOLINT
+    TickSender sender;
+    TickFollower first([] {});
+    TickFollower second([] {});
+
+    REQUIRE(sender.setName("test.send"));
+    REQUIRE(first.follow("test.send"));
+    REQUIRE(second.follow("test.send"));
+
+    sender.send(Tick {480, 3, 32}); // NOLINT
+
+    THEN("each follower gets the tick") {
+        REQUIRE(first.drain([](const Tick &) {}) == 1);
+        REQUIRE(second.drain([](const Tick &) {}) == 1);
+        REQUIRE(first.lastTick().sample == 480);
+        REQUIRE(second.lastTick().offset == 32);
+    }
+
+    WHEN("a second clock takes the same name") {
+        TickSender other;
+
+        THEN("it is refused until the first one lets go") {
+            REQUIRE(other.setName("test.mine"));
+            REQUIRE_FALSE(other.setName("test.send"));
+            REQUIRE(other.name() == "test.mine");
+
+            TickFollower mine([] {});
+            REQUIRE(mine.follow("test.mine"));
+            other.send(Tick {});
+            REQUIRE(mine.drain([](const Tick &) {}) == 1);
+
+
+            REQUIRE(sender.setName("test.other"));
+            REQUIRE(other.setName("test.send"));
+        }
+    }
+
+    WHEN("a follower stops following") {
+        first.follow("");
+        sender.send(Tick {});
+
+        THEN("only the other one gets the tick") {
+            REQUIRE(first.drain([](const Tick &) {}) == 1);
+            REQUIRE(second.drain([](const Tick &) {}) == 2);
+        }
+    }
+}
+
+SCENARIO("ClockMax object is created") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("An instance of our object") {
+        test_wrapper<ClockMax> an_instance;
+        ClockMax &myObject = an_instance;
+
+        THEN("the interval is the default") {
+            REQUIRE(static_cast<double>(myObject.interval) == 500.0); // NOLINT
+        }
+
+        WHEN("the clock is named") {
+            myObject.channel_name = "test.object";
+
+            THEN("another clock can't take the name") {
+                TickSender other;
+                REQUIRE_FALSE(other.setName("test.object"));
+            }
+
+            AND_WHEN("it is renamed to a name another clock has") {
+                TickSender other;
+                REQUIRE(other.setName("test.taken"));
+                myObject.channel_name = "test.taken";
+
+                THEN("it keeps sending on its old name and shows it") {
+                    REQUIRE(static_cast<std::string>(myObject.channel_name.get()) == "test.object");
+                    REQUIRE_FALSE(TickSender().setName("test.object"));
+                }
+            }
+        }
+    }
+}
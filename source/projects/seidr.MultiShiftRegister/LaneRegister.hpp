@@ -0,0 +1,72 @@
+/// @file       LaneRegister.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Shift registers of up to 63 bits that are stepped together.
+//
+// A lane is at most 63 bits so that every value is a positive Max integer,
+// which is a signed 64-bit number.
+//
+// Each lane is one word with its bits, and the data inputs and outputs are
+// kept in separate arrays next to it, so stepping every lane is a single
+// loop without branches that the compiler can vectorize.
+class LaneRegister {
+public:
+    enum : uint8_t {
+        MAX_LANES = 64,
+        MAX_BITS = 63
+    };
+
+    explicit LaneRegister(int lanes = 8, int bits = 8) { // NOLINT
+        this->lanes_ = std::clamp(lanes, 1, static_cast<int>(MAX_LANES));
+        this->bits_ = std::clamp(bits, 1, static_cast<int>(MAX_BITS));
+        this->mask_ = (uint64_t{1} << this->bits_) - 1;
+    }
+
+    // Shift the data input of every lane into its first bit, the last bit
+    // falls out as the data through.
+    auto step() -> void {
+        const uint64_t mask = this->mask_;
+        const int last = this->bits_ - 1;
+
+        for (int lane = 0; lane < this->lanes_; lane++) {
+            uint64_t value = this->values_[lane];
+            this->through_[lane] = static_cast<uint8_t>((value >> last) & 1U);
+            this->values_[lane] = ((value << 1U) | this->data_[lane]) & mask;
+        }
+    }
+
+    auto dataInput(int lane, int value) -> void {
+        if ((lane >= 0) && (lane < this->lanes_)) {
+            this->data_[lane] = (value != 0) ? 1 : 0;
+        }
+    }
+
+    auto clear() -> void {
+        this->values_.fill(0);
+        this->through_.fill(0);
+    }
+
+    [[nodiscard]] auto get(int lane, int bit) const -> int { return static_cast<int>((this->values_[lane] >> bit) & 1U); }
+    [[nodiscard]] auto value(int lane) const -> uint64_t { return this->values_[lane]; }
+    [[nodiscard]] auto dataThrough(int lane) const -> int { return this->through_[lane]; }
+    [[nodiscard]] auto lanes() const -> int { return this->lanes_; }
+    [[nodiscard]] auto bits() const -> int { return this->bits_; }
+
+private:
+    std::array<uint64_t, MAX_LANES> values_ = {};
+    std::array<uint8_t, MAX_LANES> data_ = {};
+    std::array<uint8_t, MAX_LANES> through_ = {};
+
+    uint64_t mask_ = 0;
+    int lanes_ = 0;
+    int bits_ = 0;
+};
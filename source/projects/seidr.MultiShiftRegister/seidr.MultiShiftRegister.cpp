@@ -0,0 +1,51 @@
+/// @file       seidr.MultiShiftRegister.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.MultiShiftRegister.hpp"
+
+using namespace c74::min;
+
+MultiShiftRegisterMax::MultiShiftRegisterMax(const atoms &args) {
+    int lanes = LANE_COUNT;
+    int bits = BIT_COUNT;
+
+    if (!args.empty()) {
+        lanes = args[0];
+    }
+
+    if (args.size() >= 2) {
+        bits = args[1];
+    }
+
+    this->register_ = LaneRegister(lanes, bits);
+
+    // The output lists are reused for every step.
+    this->outputValues_.resize(this->register_.lanes());
+    this->outputThrough_.resize(this->register_.lanes());
+};
+
+auto MultiShiftRegisterMax::step() -> void {
+    this->register_.step();
+}
+
+void MultiShiftRegisterMax::handleOutputs() {
+    for (int lane = 0; lane < this->register_.lanes(); lane++) {
+        // Lanes are at most 63 bits, every value fits.
+        this->outputValues_[lane] = static_cast<long long>(this->register_.value(lane));
+    }
+
+    this->output_values.send(this->outputValues_);
+}
+
+void MultiShiftRegisterMax::handleThrough() {
+    for (int lane = 0; lane < this->register_.lanes(); lane++) {
+        this->outputThrough_[lane] = this->register_.dataThrough(lane);
+    }
+
+    this->output_through.send(this->outputThrough_);
+}
+
+MIN_EXTERNAL(MultiShiftRegisterMax); // NOLINT
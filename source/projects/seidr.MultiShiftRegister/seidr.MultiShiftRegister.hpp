@@ -0,0 +1,122 @@
+/// @file       seidr.MultiShiftRegister.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <cstdint>
+#include <c74_min.h>
+#include "LaneRegister.hpp"
+
+using namespace c74::min;
+
+class MultiShiftRegisterMax : public object<MultiShiftRegisterMax> {
+public:
+    MIN_DESCRIPTION{"Shift registers that step together"}; // NOLINT 
+    MIN_TAGS{"seidr"};                                     // NOLINT 
+    MIN_AUTHOR{"Jóhann Berentsson"};                       // NOLINT 
+    MIN_RELATED{"seidr.*"};                                // NOLINT 
+
+    enum Inlets : uint8_t {
+        STEP = 0,
+        DATA = 1,
+        OUTPUT = 2
+    };
+
+    enum : uint8_t {
+        LANE_COUNT = 8,
+        BIT_COUNT = 8
+    };
+
+    explicit MultiShiftRegisterMax(const atoms &args = {});
+
+    void handleOutputs();
+    void handleThrough();
+    auto step() -> void;
+    auto lanes() -> int { return this->register_.lanes(); }
+    auto bits() -> int { return this->register_.bits(); }
+    auto get(int lane, int bit) -> int { return this->register_.get(lane, bit); }
+    auto value(int lane) -> uint64_t { return this->register_.value(lane); }
+    auto dataInput(int lane, int value) -> void { this->register_.dataInput(lane, value); }
+    auto dataThrough(int lane) -> int { return this->register_.dataThrough(lane); }
+
+    inlet<> input0{this, "(bang) step every lane"};
+    inlet<> input1{this, "(list|lane) data input for each lane"};
+    inlet<> input2{this, "(bang) output every lane"};
+
+    outlet<> output_values{this, "(list) value of each lane"};
+    outlet<> output_through{this, "(list) data through of each lane"};
+
+    c74::min::message<threadsafe::yes> anything{
+        this, "anything", "Handle any message",
+        MIN_FUNCTION {
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> bang{
+        this, "bang", "step the shift registers",
+        MIN_FUNCTION {
+            switch (inlet) {
+                case Inlets::STEP:
+                    this->step();
+                    this->handleThrough();
+                    this->handleOutputs();
+                    break;
+                case Inlets::OUTPUT:
+                    this->handleOutputs();
+                    break;
+                default:
+                    break;
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> integer{
+        this, "int", "data for the first lane",
+        MIN_FUNCTION {
+            if (inlet == Inlets::DATA && !args.empty()) {
+                this->dataInput(0, args[0]);
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> list{
+        this, "list", "data for each lane, starting with the first",
+        MIN_FUNCTION {
+            if (inlet == Inlets::DATA) {
+                for (int lane = 0; lane < static_cast<int>(args.size()); lane++) {
+                    this->dataInput(lane, args[lane]);
+                }
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> lane{
+        this, "lane", "data for a single lane",
+        MIN_FUNCTION {
+            if (inlet == Inlets::DATA && args.size() >= 2) {
+                this->dataInput(args[0], args[1]);
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> clear{
+        this, "clear", "set every bit to zero",
+        MIN_FUNCTION {
+            this->register_.clear();
+            return {};
+        }
+    };
+
+private:
+    LaneRegister register_;
+    atoms outputValues_;
+    atoms outputThrough_;
+};
@@ -0,0 +1,94 @@
+/// @file       seidr.MultiShiftRegister_test.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.MultiShiftRegister.cpp" // NOLINT
+#include "seidr.MultiShiftRegister.hpp"
+#include <c74_min_unittest.h>
+
+using namespace c74::max;
+
+SCENARIO("create a multi lane instance") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<MultiShiftRegisterMax> an_instance;
+    MultiShiftRegisterMax &shiftRegister = an_instance;
+
+    auto &values = *c74::max::object_getoutput(shiftRegister, 0);
+    auto &through = *c74::max::object_getoutput(shiftRegister, 1);
+
+    REQUIRE(shiftRegister.lanes() == MultiShiftRegisterMax::LANE_COUNT);
+    REQUIRE(shiftRegister.bits() == MultiShiftRegisterMax::BIT_COUNT);
+
+    WHEN("all bits are zero") {
+        for (int lane = 0; lane < shiftRegister.lanes(); lane++) {
+            for (int bit = 0; bit < shiftRegister.bits(); bit++) {
+                REQUIRE(shiftRegister.get(lane, bit) == 0);
+            }
+        }
+    }
+
+    WHEN("every other lane gets a one") {
+        shiftRegister.list({ 1, 0, 1, 0, 1, 0, 1, 0 }, MultiShiftRegisterMax::Inlets::DATA); // NOLINT
+        shiftRegister.bang();
+
+        THEN("every lane is stepped by a single bang") {
+            for (int lane = 0; lane < shiftRegister.lanes(); lane++) {
+                REQUIRE(shiftRegister.get(lane, 0) == ((lane % 2 == 0) ? 1 : 0));
+            }
+
+            REQUIRE(values.size() == 1);
+            REQUIRE(values[0].size() == MultiShiftRegisterMax::LANE_COUNT);
+            REQUIRE(values[0][0] == 1);
+            REQUIRE(values[0][1] == 0);
+            REQUIRE(through.size() == 1);
+        }
+
+        THEN("the bits fall out of the last stage") {
+            for (int i = 1; i < shiftRegister.bits(); i++) {
+                shiftRegister.bang();
+            }
+
+            REQUIRE(shiftRegister.value(0) == 0xFF); // NOLINT
+            REQUIRE(shiftRegister.dataThrough(0) == 0);
+
+            shiftRegister.bang();
+
+            REQUIRE(shiftRegister.dataThrough(0) == 1);
+            REQUIRE(shiftRegister.dataThrough(1) == 0);
+        }
+    }
+
+    WHEN("a single lane is set") {
+        shiftRegister.lane({ 3, 1 }, MultiShiftRegisterMax::Inlets::DATA); // NOLINT
+        shiftRegister.bang();
+        shiftRegister.lane({ 3, 0 }, MultiShiftRegisterMax::Inlets::DATA); // NOLINT
+        shiftRegister.bang();
+
+        THEN("only that lane changes") {
+            REQUIRE(shiftRegister.value(3) == 2);
+            REQUIRE(shiftRegister.value(2) == 0);
+        }
+    }
+}
+
+SCENARIO("a lane is never wider than a Max integer") { // NOLINT
+    LaneRegister lanes(1, 64); // NOLINT
+
+    REQUIRE(lanes.bits() == LaneRegister::MAX_BITS);
+
+    WHEN("every bit is set") {
+        lanes.dataInput(0, 1);
+
+        for (int bit = 0; bit < lanes.bits(); bit++) {
+            lanes.step();
+        }
+
+        THEN("the value is the largest positive integer") {
+            REQUIRE(lanes.value(0) == static_cast<uint64_t>(INT64_MAX));
+            REQUIRE(static_cast<long long>(lanes.value(0)) > 0);
+        }
+    }
+}
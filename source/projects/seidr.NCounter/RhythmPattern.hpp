@@ -0,0 +1,61 @@
+/// @file       RhythmPattern.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+// A rhythm of up to 64 steps stored as a bitmask.
+//
+// The mask is built once when the pattern changes, playing a step is a
+// shift and a mask.
+class RhythmPattern {
+public:
+    enum : uint8_t {
+        MAX_LENGTH = 64
+    };
+
+    // Spread hits as evenly as possible over length steps, the same
+    // rhythms as Bjorklund's algorithm, rotated by rotation steps.
+    static auto euclidean(int hits, int length, int rotation = 0) -> RhythmPattern {
+        RhythmPattern pattern;
+        length = std::clamp(length, 1, static_cast<int>(MAX_LENGTH));
+        hits = std::clamp(hits, 0, length);
+        rotation = ((rotation % length) + length) % length;
+
+        for (int step = 0; step < length; step++) {
+            if (((step * hits) % length) < hits) {
+                pattern.mask_ |= uint64_t{1} << ((step + rotation) % length);
+            }
+        }
+
+        pattern.length_ = static_cast<uint8_t>(length);
+        return pattern;
+    }
+
+    // A pattern from a list of steps, anything but zero is a hit.
+    template <typename Steps> static auto fromSteps(const Steps &steps) -> RhythmPattern {
+        RhythmPattern pattern;
+        int length = std::clamp(static_cast<int>(steps.size()), 1, static_cast<int>(MAX_LENGTH));
+
+        for (int step = 0; step < std::min(length, static_cast<int>(steps.size())); step++) {
+            if (static_cast<int>(steps[step]) != 0) {
+                pattern.mask_ |= uint64_t{1} << step;
+            }
+        }
+
+        pattern.length_ = static_cast<uint8_t>(length);
+        return pattern;
+    }
+
+    [[nodiscard]] auto get(uint64_t step) const -> bool { return ((this->mask_ >> (step % this->length_)) & 1U) != 0; }
+    [[nodiscard]] auto mask() const -> uint64_t { return this->mask_; }
+    [[nodiscard]] auto length() const -> int { return this->length_; }
+
+private:
+    uint64_t mask_ = 0;
+    uint8_t length_ = 1;
+};
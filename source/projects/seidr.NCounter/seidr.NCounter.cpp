@@ -5,33 +5,165 @@
 ///             found in the License.md file.
 
 #include "seidr.NCounter.hpp" // NOLINT
+#include <algorithm>
 
 NCounterMax::NCounterMax(const atoms &args) {
     if (!args.empty()) {
-        this->stepCount_ = args[0];
+        this->stepCount_ = static_cast<uint16_t>(std::clamp(static_cast<int>(args[0]), 0, UINT16_MAX));
     }
 
-    for (int i = 0; i < this->stepCount_; i++) {
-        outputs.push_back(std::make_unique<outlet<>>(this, "(anything) output bit " + std::to_string(i)));
-    }
+    static OutletNames names("(anything) output bit ");
+    this->outputs.create(this, this->stepCount_, names);
 
-    this->counter_ = Counter(this->stepCount_);
+    this->counter_.setMaxValue(this->stepCount_);
+    this->patterns_.resize(this->stepCount_);
+
+    // State saved with the patcher.
+    StateSnapshot::load(this->state(), this->slots_, [this](StateReader &reader) { return this->restore(reader); });
 };
 
+auto NCounterMax::snapshot() -> std::vector<uint8_t> {
+    StateWriter writer(STATE_VERSION);
+    writer.write(this->counter_.load());
+    writer.write(this->bangEnabled_);
+    writer.write(this->patternMode_);
+    writer.writeArray(this->patterns_.data(), this->patterns_.size());
+    return std::move(writer.bytes());
+}
+
+auto NCounterMax::restore(StateReader &reader) -> bool {
+    AtomicCounter::State counter {};
+    bool bangEnabled = false;
+    bool patternMode = false;
+
+    if ((reader.version() != STATE_VERSION) || !reader.read(counter) || !reader.read(bangEnabled) || !reader.read(patternMode)) {
+        return false;
+    }
+
+    // The patterns are copied in place. A snapshot from an object with
+    // another number of outputs fills the outputs they have in common.
+    size_t count = 0;
+
+    if (!reader.readArray(this->patterns_.data(), this->patterns_.size(), count)) {
+        return false;
+    }
+
+    std::fill(this->patterns_.begin() + static_cast<std::ptrdiff_t>(count), this->patterns_.end(), RhythmPattern());
+
+    this->counter_.restore(counter);
+    this->ticks_.store(counter.started ? (counter.value + 1) : 0, std::memory_order_relaxed);
+    this->bangEnabled_ = bangEnabled;
+    this->patternMode_ = patternMode;
+    return true;
+}
+
+auto NCounterMax::recallSlot(int slot) -> bool {
+    return this->slots_.recall(slot, [this](StateReader &reader) { return this->restore(reader); });
+}
+
+auto NCounterMax::setPattern(int output, const RhythmPattern &pattern) -> void {
+    if ((output < 0) || (output >= static_cast<int>(this->patterns_.size()))) {
+        return;
+    }
+
+    this->patterns_[output] = pattern;
+    this->patternMode_ = true;
+}
+
+auto NCounterMax::isActive(int output) -> bool {
+    return this->isActive(output, this->counter_.value(), this->patternStep());
+}
+
+// The first tick after a reset plays step 0, like the counter.
+auto NCounterMax::patternStep() const -> uint64_t {
+    uint64_t ticks = this->ticks_.load(std::memory_order_relaxed);
+    return (ticks > 0) ? (ticks - 1) : 0;
+}
+
+auto NCounterMax::isActive(int output, unsigned int value, uint64_t step) -> bool {
+    if (this->patternMode_) {
+        return this->patterns_[output].get(step);
+    }
+
+    return output == static_cast<int>(value);
+}
+
 void NCounterMax::handleOutputs() {
+    // Read the counter once so the outputs agree on the step.
+    unsigned int value = this->counter_.value();
+    uint64_t step = this->patternStep();
+
     for (int i = 0; i < this->stepCount_; i++) {
-        bool isActive = i == this->counter_.value();
+        bool active = this->isActive(i, value, step);
 
-        if (this->bangEnabled_ && isActive) {
-            this->outputs[i]->send("bang");
+        if (this->bangEnabled_ && active) {
+            this->outputs[i].send("bang");
         } else {
-            this->outputs[i]->send(isActive);
+            this->outputs[i].send(active);
         }
     }
 }
 
+auto NCounterMax::memoryUsage() const -> size_t {
+    return sizeof(*this) + this->outputs.bytes() + (this->patterns_.capacity() * sizeof(RhythmPattern)) + this->slots_.bytes();
+}
+
 auto NCounterMax::counterValue() -> unsigned int {
     return this->counter_.value();
 }
 
+auto NCounterMax::tick() -> void {
+    this->ticks_.fetch_add(1, std::memory_order_relaxed);
+    this->counter_.tick();
+    this->handleOutputs();
+}
+
+auto NCounterMax::pulse() -> void {
+    bool stepped = this->budget_.run(EventBudget::now(), [this] {
+        // Steps merged in an earlier tick go first.
+        this->flush();
+        this->tick();
+    });
+
+    if (!stepped) {
+        this->budget_.shed();
+
+        if (this->pendingSteps_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            this->flush_tick.delay(0);
+        }
+    }
+}
+
+auto NCounterMax::flush() -> void {
+    uint32_t steps = this->pendingSteps_.exchange(0, std::memory_order_relaxed);
+
+    if (steps > 0) {
+        this->stepBy(static_cast<int>(steps));
+    }
+}
+
+auto NCounterMax::setBudget(int events, int microseconds) -> void {
+    this->budget_.set(static_cast<uint32_t>(std::max(events, 0)), static_cast<uint32_t>(std::max(microseconds, 0)));
+}
+
+auto NCounterMax::stepBy(int steps) -> void {
+    if (steps <= 0) {
+        return;
+    }
+
+    this->ticks_.fetch_add(static_cast<uint64_t>(steps), std::memory_order_relaxed);
+    this->counter_.tick(static_cast<unsigned int>(steps));
+    this->handleOutputs();
+}
+
+auto NCounterMax::locateAt(int position) -> void {
+    if (position < 0) {
+        return;
+    }
+
+    this->ticks_.store(static_cast<uint64_t>(position) + 1, std::memory_order_relaxed);
+    this->counter_.locate(static_cast<unsigned int>(position));
+    this->handleOutputs();
+}
+
 MIN_EXTERNAL(NCounterMax); // NOLINT
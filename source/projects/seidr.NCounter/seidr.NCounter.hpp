@@ -5,13 +5,25 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <c74_min.h>
-#include "Counter/Counter.hpp"
+#include "AtomicCounter.hpp"
+#include "ClockFollower.hpp"
+#include "InternalClock.hpp"
+#include "EventBudget.hpp"
+#include "MessageArgs.hpp"
+#include "OutletArray.hpp"
+#include "RhythmPattern.hpp"
+#include "StateSnapshot.hpp"
 
 using namespace c74::min;
 
 class NCounterMax : public object<NCounterMax> {
+private:
+    InternalClock clock_ {this, [this] { return static_cast<double>(this->interval.get()); }, [this] { this->tick(); }};
+    ClockFollower follower_ {this, [this] { this->tick(); }};
+
 public:
     MIN_DESCRIPTION{"NCounter"};     // NOLINT 
     MIN_TAGS{"jb, counter"};         // NOLINT 
@@ -19,39 +31,91 @@ public:
     MIN_RELATED{"seidr.*"};          // NOLINT 
 
     enum : uint8_t {
-        OUTPUT_COUNT = 10
+        OUTPUT_COUNT = 10,
+        STATE_VERSION = 1
     };
 
     explicit NCounterMax(const atoms &args = {});
 
+    // Stops following before the timers go, the clock can wake it until then.
+    ~NCounterMax() { this->follower_.follow(""); }
+
+    NCounterMax(const NCounterMax &) = delete;
+    auto operator=(const NCounterMax &) -> NCounterMax & = delete;
+
     void handleOutputs();
     auto counterValue() -> unsigned int;
     auto step() -> unsigned int;
+    auto stepBy(int steps) -> void;
+    auto locateAt(int position) -> void;
+    auto tick() -> void;
+    auto pulse() -> void;
+    auto flush() -> void;
+    auto followClock() -> int { return this->follower_.drain(); }
+    auto lastTick() const -> const Tick & { return this->follower_.lastTick(); }
+    auto setPattern(int output, const RhythmPattern &pattern) -> void;
+    auto setPatternMode(bool enabled) -> void { this->patternMode_ = enabled; }
+    auto isPatternMode() const -> bool { return this->patternMode_; }
+    auto isActive(int output) -> bool;
+    auto memoryUsage() const -> size_t;
+    auto setBudget(int events, int microseconds) -> void;
+    auto shedCount() const -> uint64_t { return this->budget_.shedCount(); }
+
+    // State snapshots.
+    auto snapshot() -> std::vector<uint8_t>;
+    auto restore(StateReader &reader) -> bool;
+    auto recallSlot(int slot) -> bool;
 
     inlet<> input0{this, "(bang) input pulse"};
     inlet<> input1{this, "(int | reset | preset | preset_value) reset pulse"};
 
-    std::vector<std::unique_ptr<outlet<>>> outputs;
+    OutletArray<> outputs;
     
     argument<symbol> bangArg{this, "bang_on", "Initial value for the bang attribute.", MIN_ARGUMENT_FUNCTION{bangEnabled_ = FALSE; }};
 
     message<threadsafe::yes> bang {this, "bang", "Steps the counter.",
         MIN_FUNCTION{
-            if (this->alreadyBanged_){
-                this->counter_.step();
-            } else {
-                this->alreadyBanged_ = true;
-            }
+            this->pulse();
+            return {};
+        }
+    };
 
-            this->handleOutputs();
+    // Coalesced steps, sent on the next tick.
+    timer<> flush_tick {this,
+        MIN_FUNCTION{
+            this->flush();
             return {};
         }
     };
 
+    attribute<time_value> interval {this, "interval", 0.0,
+        description{"Step on an internal clock every interval, in ms or a note value. 0 turns the clock off."},
+        setter{
+            MIN_FUNCTION{
+                this->clock_.changed();
+                return args;
+            }
+        }
+    };
+
+    attribute<symbol> clock_name {this, "clock", "",
+        description{"Step on the ticks of the seidr.Clock~ with this name. Empty stops following."},
+        setter{
+            MIN_FUNCTION{
+                std::string name = args[0];
+
+                if (!this->follower_.follow(name)) {
+                    c74::max::object_error((c74::max::t_object*) this, "too many objects follow %s", name.c_str());
+                }
+                return args;
+            }
+        }
+    };
+
     message<threadsafe::yes> reset {this, "reset", "Reset the counter.",
         MIN_FUNCTION{
             this->counter_.reset();
-            this->alreadyBanged_ = false;
+            this->ticks_.store(0, std::memory_order_relaxed);
             return {};
         }
     };
@@ -59,7 +123,14 @@ public:
     message<threadsafe::yes> max_value {this, "max", "Set the counter max value.",
         MIN_FUNCTION{
             if(!args.empty()){
-                this->counter_.setMaxValue(static_cast<int> (args[0]));
+                int value = 0;
+
+                if (!MessageArgs::readInt(args[0], value)) {
+                    c74::max::object_error((c74::max::t_object*) this, "max needs a number");
+                    return {};
+                }
+
+                this->counter_.setMaxValue(value);
             }
             
             return {};
@@ -69,7 +140,14 @@ public:
     message<threadsafe::yes> preset_value {this, "preset_value", "Set the counter preset value.",
         MIN_FUNCTION{
             if(!args.empty()){
-                this->counter_.setPreset(static_cast<int> (args[0]));
+                int value = 0;
+
+                if (!MessageArgs::readInt(args[0], value)) {
+                    c74::max::object_error((c74::max::t_object*) this, "preset_value needs a number");
+                    return {};
+                }
+
+                this->counter_.setPreset(value);
             }
 
             return {};
@@ -83,6 +161,164 @@ public:
         }
     };
 
+    message<threadsafe::yes> step_msg {this, "step", "Step the counter n times and output only the result.",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                int steps = 0;
+
+                if (!MessageArgs::readInt(args[0], steps)) {
+                    c74::max::object_error((c74::max::t_object*) this, "step needs a number of steps");
+                    return {};
+                }
+
+                this->stepBy(steps);
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> locate_msg {this, "locate", "Go to the value n steps after a reset.",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                int position = 0;
+
+                if (!MessageArgs::readInt(args[0], position)) {
+                    c74::max::object_error((c74::max::t_object*) this, "locate needs a number of steps");
+                    return {};
+                }
+
+                this->locateAt(position);
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> euclid {this, "euclid", "Play a euclidean rhythm on an output: output hits length rotation.",
+        MIN_FUNCTION{
+            if(args.size() >= 3){
+                int output = 0;
+                int hits = 0;
+                int length = 0;
+                int rotation = 0;
+
+                if (!MessageArgs::readInts(args, output, hits, length) || ((args.size() >= 4) && !MessageArgs::readInt(args[3], rotation))) {
+                    c74::max::object_error((c74::max::t_object*) this, "euclid needs an output, hits, length and an optional rotation");
+                    return {};
+                }
+
+                this->setPattern(output, RhythmPattern::euclidean(hits, length, rotation));
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> pattern {this, "pattern", "Play a rhythm on an output: output followed by a 0 or 1 for each step.",
+        MIN_FUNCTION{
+            if(args.size() >= 2){
+                int output = 0;
+                std::vector<int> steps(args.size() - 1);
+                bool valid = MessageArgs::readInt(args[0], output);
+
+                for (size_t step = 0; valid && (step < steps.size()); step++) {
+                    valid = MessageArgs::readInt(args[step + 1], steps[step]);
+                }
+
+                if (!valid) {
+                    c74::max::object_error((c74::max::t_object*) this, "pattern needs an output and a 0 or 1 for each step");
+                    return {};
+                }
+
+                this->setPattern(output, RhythmPattern::fromSteps(steps));
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> mode {this, "mode", "step for one active output, pattern for a rhythm on each output.",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                this->setPatternMode(MessageArgs::isSymbol(args[0], MessageArgs::PATTERN));
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> memory {this, "memory", "Post the number of bytes used by this instance.",
+        MIN_FUNCTION{
+            c74::max::object_post((c74::max::t_object*) this, "%zu bytes", this->memoryUsage());
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> budget {this, "budget", "Bangs and microseconds per scheduler tick, bangs over it are merged into one step. No arguments turns it off.",
+        MIN_FUNCTION{
+            int events = 0;
+            int microseconds = 0;
+
+            if (!MessageArgs::readOptionalInts(args, events, microseconds)) {
+                c74::max::object_error((c74::max::t_object*) this, "budget needs a number of bangs and microseconds");
+                return {};
+            }
+
+            this->setBudget(events, microseconds);
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> shed {this, "shed", "Post the number of bangs merged to stay in the budget.",
+        MIN_FUNCTION{
+            c74::max::object_post((c74::max::t_object*) this, "%llu shed", static_cast<unsigned long long> (this->shedCount()));
+            return {};
+        }
+    };
+
+    message<> store {this, "store", "Store the state in a slot (0-15).",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    c74::max::object_error((c74::max::t_object*) this, "store needs a slot number");
+                    return {};
+                }
+
+                this->slots_.store(slot, this->snapshot());
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> recall {this, "recall", "Recall the state stored in a slot (0-15).",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    c74::max::object_error((c74::max::t_object*) this, "recall needs a slot number");
+                    return {};
+                }
+
+                this->recallSlot(slot);
+            }
+
+            return {};
+        }
+    };
+
+    message<> savestate {this, "savestate", "Save the state and the slots with the patcher.",
+        MIN_FUNCTION{
+            dict state {args[0]};
+            StateSnapshot::save(state, this->snapshot(), this->slots_);
+            return {};
+        }
+    };
+
     message<threadsafe::yes> bangEnable {this, "bangEnable", "Enable bang outputs.",
         MIN_FUNCTION{
             this->bangEnabled_ = true;
@@ -98,9 +334,24 @@ public:
     };
 
 private:
-    Counter counter_;
-    std::vector<int> outputStates_;
+    AtomicCounter counter_;
+    std::vector<RhythmPattern> patterns_;
+    uint16_t stepCount_ = OUTPUT_COUNT;
     bool bangEnabled_ = false;
-    bool alreadyBanged_ = false;
-    int stepCount_ = OUTPUT_COUNT;
+    bool patternMode_ = false;
+
+    StateSlots<> slots_;
+
+    // Overload protection, bangs over the budget are counted and stepped in
+    // one jump on the next tick.
+    EventBudget budget_;
+    std::atomic<uint32_t> pendingSteps_ {0};
+
+    // Ticks since the last reset. The patterns play on this rather than on
+    // the counter value, which wraps at the number of outputs, so a pattern
+    // longer than that still plays all of its steps.
+    std::atomic<uint64_t> ticks_ {0};
+
+    auto patternStep() const -> uint64_t;
+    auto isActive(int output, unsigned int value, uint64_t step) -> bool;
 };
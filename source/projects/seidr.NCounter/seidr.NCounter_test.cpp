@@ -7,6 +7,10 @@
 #include "seidr.NCounter.cpp" // NOLINT
 #include "seidr.NCounter.hpp"
 #include <c74_min_unittest.h>
+#include "InstantiationBenchmark.hpp"
+#include "StressRunner.hpp"
+#include <iostream>
+#include <thread>
 
 using namespace c74::max;
 
@@ -188,3 +192,371 @@ SCENARIO("enable bangs works") { // NOLINT
         }
     }
 }
+
+SCENARIO("NCounterMax jumps ahead") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("two instances of our object") {
+        test_wrapper<NCounterMax> stepped_instance;
+        test_wrapper<NCounterMax> jumped_instance;
+        NCounterMax &stepped = stepped_instance;
+        NCounterMax &jumped = jumped_instance;
+
+        WHEN("one is banged and the other is stepped in one message") {
+            for (int i = 0; i < 23; i++) { // NOLINT
+                stepped.bang();
+            }
+
+            jumped.step_msg({ 23 }); // NOLINT
+
+            THEN("they end on the same value") {
+                REQUIRE(jumped.counterValue() == stepped.counterValue());
+            }
+
+            THEN("only the result is output") {
+                auto &out = *object_getoutput(jumped, 0);
+                REQUIRE(out.size() == 1);
+            }
+        }
+
+        WHEN("the counter is located") {
+            for (int i = 0; i < 14; i++) { // NOLINT
+                stepped.bang();
+            }
+
+            jumped.bang();
+            jumped.locate_msg({ 13 }); // NOLINT
+
+            THEN("it is on the value that many steps after a reset") {
+                REQUIRE(jumped.counterValue() == stepped.counterValue());
+            }
+        }
+    }
+}
+
+SCENARIO("NCounterMax plays rhythm patterns") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("euclidean patterns") {
+        THEN("the hits are spread evenly") {
+            REQUIRE(RhythmPattern::euclidean(3, 8).mask() == 0x49); // NOLINT
+            REQUIRE(RhythmPattern::euclidean(4, 16).mask() == 0x1111); // NOLINT
+            REQUIRE(RhythmPattern::euclidean(0, 8).mask() == 0); // NOLINT
+            REQUIRE(RhythmPattern::euclidean(8, 8).mask() == 0xFF); // NOLINT
+            REQUIRE(RhythmPattern::euclidean(3, 8, 1).mask() == 0x92); // NOLINT
+        }
+    }
+
+    GIVEN("An instance of our object") {
+        test_wrapper<NCounterMax> an_instance;
+        NCounterMax &myObject = an_instance;
+
+        myObject.euclid({ 0, 3, 8 }); // NOLINT
+        myObject.pattern({ 1, 1, 0, 1 }); // NOLINT
+
+        REQUIRE(myObject.isPatternMode());
+
+        WHEN("the counter is stepped") {
+            int expected[10][2] = { // NOLINT
+                {1, 1}, {0, 0}, {0, 1}, {1, 1}, {0, 0},
+                {0, 1}, {1, 1}, {0, 0}, {1, 1}, {0, 1}
+            };
+
+            THEN("each output plays its pattern") {
+                for (int step = 0; step < 10; step++) { // NOLINT
+                    myObject.bang();
+
+                    for (int output = 0; output < 2; output++) {
+                        REQUIRE(myObject.isActive(output) == (expected[step][output] == 1));
+                    }
+                }
+            }
+        }
+
+        WHEN("a pattern is longer than the counter") {
+            myObject.max_value({ 4 }); // NOLINT
+            myObject.pattern({ 2, 0, 0, 0, 0, 0, 1, 0, 1 }); // NOLINT
+
+            THEN("the pattern plays all of its steps while the counter wraps") {
+                std::vector<bool> played;
+
+                for (int step = 0; step < 16; step++) { // NOLINT
+                    myObject.bang();
+                    played.push_back(myObject.isActive(2));
+                }
+
+                REQUIRE(myObject.counterValue() == 3);
+                REQUIRE(played == std::vector<bool> {false, false, false, false, false, true, false, true,
+                                                     false, false, false, false, false, true, false, true});
+            }
+
+            THEN("a reset starts the pattern again") {
+                for (int step = 0; step < 6; step++) { // NOLINT
+                    myObject.bang();
+                }
+
+                REQUIRE(myObject.isActive(2));
+
+                myObject.reset();
+                myObject.bang();
+
+                REQUIRE(!myObject.isActive(2));
+            }
+        }
+
+        WHEN("step mode is turned back on") {
+            myObject.mode({ "step" });
+            myObject.bang();
+
+            THEN("only the current step is active") {
+                REQUIRE(!myObject.isPatternMode());
+                REQUIRE(myObject.isActive(0));
+                REQUIRE(!myObject.isActive(1));
+            }
+        }
+    }
+}
+
+SCENARIO("NCounterMax counter state is shared between threads") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<NCounterMax> an_instance;
+    NCounterMax &myObject = an_instance;
+
+    GIVEN("max and reset changing while the counter steps") {
+        std::thread settings([&myObject] {
+            for (int i = 0; i < 10000; i++) { // NOLINT
+                myObject.max_value(static_cast<int>(i % 10) + 1); // NOLINT
+                myObject.reset(c74::min::atoms {}, 1);
+            }
+        });
+
+        for (int i = 0; i < 10000; i++) { // NOLINT
+            REQUIRE_NOTHROW(myObject.step_msg({ 3 }, 0)); // NOLINT
+        }
+
+        settings.join();
+
+        THEN("the value is always inside the last max") {
+            REQUIRE(myObject.counterValue() < 10); // NOLINT
+            REQUIRE_NOTHROW(myObject.max_value(4)); // NOLINT
+            REQUIRE_NOTHROW(myObject.locate_msg({ 6 }, 0)); // NOLINT
+            REQUIRE(myObject.counterValue() == 2);
+        }
+    }
+}
+
+SCENARIO("NCounterMax reports the memory it uses") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<NCounterMax> an_instance;
+    NCounterMax &myObject = an_instance;
+
+    THEN("the outlets are counted with the instance") {
+        REQUIRE(myObject.memoryUsage() >= sizeof(NCounterMax) + NCounterMax::OUTPUT_COUNT * sizeof(c74::min::outlet<>));
+    }
+
+    THEN("the memory message can be sent") {
+        REQUIRE_NOTHROW(myObject.memory());
+    }
+}
+
+SCENARIO("NCounterMax saves and recalls its state") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<NCounterMax> an_instance;
+    NCounterMax &myObject = an_instance;
+
+    GIVEN("patterns and a counter that has been stepped") {
+        myObject.euclid({ 0, 3, 8 }); // NOLINT
+        myObject.pattern({ 1, 0, 1 }); // NOLINT
+
+        for (int step = 0; step < 4; step++) {
+            myObject.bang();
+        }
+
+        unsigned int stored = myObject.counterValue();
+        bool active[2] = { myObject.isActive(0), myObject.isActive(1) }; // NOLINT
+
+        WHEN("the state is stored, changed and recalled") {
+            myObject.store({ 1 });
+
+            myObject.mode({ "step" });
+            myObject.euclid({ 0, 0, 8 }); // NOLINT
+            myObject.bang();
+            myObject.bang();
+
+            myObject.recall({ 1 });
+
+            THEN("the counter and the patterns are back") {
+                REQUIRE(myObject.isPatternMode());
+                REQUIRE(myObject.counterValue() == stored);
+                REQUIRE(myObject.isActive(0) == active[0]);
+                REQUIRE(myObject.isActive(1) == active[1]);
+            }
+        }
+
+        WHEN("a snapshot is restored into another object") {
+            test_wrapper<NCounterMax> other_instance;
+            NCounterMax &otherObject = other_instance;
+
+            auto snapshot = myObject.snapshot();
+            StateReader reader(snapshot);
+
+            THEN("it continues from the same step") {
+                REQUIRE(otherObject.restore(reader));
+                REQUIRE(otherObject.counterValue() == stored);
+
+                myObject.bang();
+                otherObject.bang();
+                REQUIRE(otherObject.isActive(0) == myObject.isActive(0));
+                REQUIRE(otherObject.isActive(1) == myObject.isActive(1));
+            }
+        }
+
+        WHEN("an empty slot is recalled") {
+            THEN("nothing is restored") {
+                REQUIRE_FALSE(myObject.recallSlot(2));
+                REQUIRE(myObject.counterValue() == stored);
+            }
+        }
+    }
+}
+
+SCENARIO("NCounterMax merges bangs over its budget") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<NCounterMax> stepped_instance;
+    test_wrapper<NCounterMax> budgeted_instance;
+    NCounterMax &stepped = stepped_instance;
+    NCounterMax &budgeted = budgeted_instance;
+
+    budgeted.budget({ 3 });
+
+    WHEN("a burst of bangs arrives in one tick") {
+        for (int i = 0; i < 7; i++) { // NOLINT
+            stepped.bang();
+            budgeted.bang();
+        }
+
+        THEN("the bangs over the budget are counted and stepped later in one jump") {
+            REQUIRE(budgeted.shedCount() == 4);
+            REQUIRE(budgeted.counterValue() == 2);
+
+            budgeted.flush();
+            REQUIRE(budgeted.counterValue() == stepped.counterValue());
+        }
+    }
+
+    WHEN("the budget is turned off") {
+        budgeted.budget();
+
+        for (int i = 0; i < 7; i++) { // NOLINT
+            budgeted.bang();
+        }
+
+        THEN("every bang steps") {
+            REQUIRE(budgeted.shedCount() == 0);
+            REQUIRE(budgeted.counterValue() == 6);
+        }
+    }
+}
+
+SCENARIO("NCounterMax follows a seidr.Clock~") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<NCounterMax> an_instance;
+    NCounterMax &myObject = an_instance;
+    TickSender clock;
+
+    REQUIRE(clock.setName("test.ncounter"));
+    myObject.clock_name = "test.ncounter";
+
+    WHEN("the clock ticks three times in one vector") {
+        for (uint32_t i = 0; i < 3; i++) {
+            clock.send(Tick {i * 100, i, static_cast<uint16_t>(i * 20)}); // NOLINT
+        }
+
+        THEN("the counter steps once for every tick and knows the sample of the last one") {
+            REQUIRE(myObject.followClock() == 3);
+            REQUIRE(myObject.counterValue() == 2);
+            REQUIRE(myObject.lastTick().sample == 200);
+            REQUIRE(myObject.lastTick().offset == 40);
+        }
+    }
+
+    WHEN("the counter stops following") {
+        myObject.clock_name = "";
+        clock.send(Tick {});
+
+        THEN("the tick doesn't reach it") {
+            REQUIRE(myObject.followClock() == 0);
+        }
+    }
+}
+
+SCENARIO("NCounterMax under concurrent messages", "[.stress]") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<NCounterMax> an_instance;
+    NCounterMax &myObject = an_instance;
+
+    // Every output is a bang or the state of a step.
+    uint64_t sent = 0;
+    uint64_t invalid = 0;
+
+    auto drain = [&] {
+        for (int i = 0; i < NCounterMax::OUTPUT_COUNT; i++) {
+            auto &out = *object_getoutput(myObject, i);
+
+            for (const auto &entry : out) {
+                const auto &value = entry.back();
+                bool isBang = value.type() == c74::min::message_type::symbol_argument;
+                invalid += (isBang || (static_cast<int>(value) == 0) || (static_cast<int>(value) == 1)) ? 0 : 1;
+            }
+
+            sent += out.size();
+            out.clear();
+        }
+    };
+
+    StressRunner stress(100000); // NOLINT
+
+    stress.scheduler("bang", [&](uint64_t) { myObject.bang(); }, drain);
+
+    stress.main("max", [&](uint64_t n) {
+        myObject.max_value(static_cast<int>(n % 10) + 1); // NOLINT
+    });
+
+    stress.main("preset", [&](uint64_t n) {
+        myObject.preset_value(static_cast<int>(n % 10), 1); // NOLINT
+        myObject.preset(c74::min::atoms {}, 1);
+    });
+
+    StressRunner::report("seidr.NCounter", stress.run(), std::cout);
+
+    THEN("every output is a bang or a step state and the state can be read") {
+        REQUIRE(sent > 0);
+        REQUIRE(invalid == 0);
+
+        std::vector<uint8_t> state = myObject.snapshot();
+        StateReader reader(state);
+
+        REQUIRE(reader.isValid());
+        REQUIRE(myObject.restore(reader));
+    }
+}
+
+SCENARIO("NCounterMax instantiation cost", "[.benchmark]") { // NOLINT
+    ext_main(nullptr);
+
+    auto result = InstantiationBenchmark::run<test_wrapper<NCounterMax>>(10000); // NOLINT
+    InstantiationBenchmark::report("seidr.NCounter", result, std::cout);
+
+    THEN("every object was created and each one after the first costs the same") {
+        REQUIRE(result.count == 10000); // NOLINT
+        REQUIRE(result.lastAllocations > 0);
+        REQUIRE(result.lastAllocations < result.firstAllocations);
+        REQUIRE(result.allocations == Approx(result.lastAllocations).margin(0.01)); // NOLINT
+    }
+}
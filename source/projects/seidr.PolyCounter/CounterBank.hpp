@@ -0,0 +1,75 @@
+/// @file       CounterBank.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// Counters with their own lengths that are stepped together.
+//
+// The values and the lengths are kept in two arrays, so stepping every
+// counter is one loop without branches. A step returns a mask with a bit
+// for every counter that wrapped around to its first step.
+class CounterBank {
+public:
+    enum : uint8_t {
+        MAX_COUNTERS = 64
+    };
+
+    auto setLengths(const int *lengths, int count) -> void {
+        this->count_ = std::clamp(count, 1, static_cast<int>(MAX_COUNTERS));
+
+        for (int counter = 0; counter < this->count_; counter++) {
+            this->lengths_[counter] = static_cast<uint32_t>(std::max(lengths[counter], 1));
+            this->values_[counter] %= this->lengths_[counter];
+        }
+    }
+
+    auto setLength(int counter, int length) -> void {
+        if ((counter >= 0) && (counter < this->count_)) {
+            this->lengths_[counter] = static_cast<uint32_t>(std::max(length, 1));
+            this->values_[counter] %= this->lengths_[counter];
+        }
+    }
+
+    auto step() -> uint64_t {
+        uint64_t wrapped = 0;
+
+        for (int counter = 0; counter < this->count_; counter++) {
+            uint32_t next = this->values_[counter] + 1;
+            uint64_t wrap = (next >= this->lengths_[counter]) ? 1 : 0;
+
+            this->values_[counter] = wrap ? 0 : next;
+            wrapped |= wrap << counter;
+        }
+
+        return wrapped;
+    }
+
+    auto reset() -> void { this->values_.fill(0); }
+
+    // A mask with a bit for every counter that is on its first step.
+    [[nodiscard]] auto firstSteps() const -> uint64_t {
+        uint64_t mask = 0;
+
+        for (int counter = 0; counter < this->count_; counter++) {
+            mask |= static_cast<uint64_t>(this->values_[counter] == 0) << counter;
+        }
+
+        return mask;
+    }
+
+    [[nodiscard]] auto value(int counter) const -> uint32_t { return this->values_[counter]; }
+    [[nodiscard]] auto length(int counter) const -> uint32_t { return this->lengths_[counter]; }
+    [[nodiscard]] auto size() const -> int { return this->count_; }
+
+private:
+    std::array<uint32_t, MAX_COUNTERS> values_ = {};
+    std::array<uint32_t, MAX_COUNTERS> lengths_ = {};
+    int count_ = 0;
+};
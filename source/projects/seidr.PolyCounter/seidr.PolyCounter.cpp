@@ -0,0 +1,82 @@
+/// @file       seidr.PolyCounter.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.PolyCounter.hpp"
+
+PolyCounterMax::PolyCounterMax(const atoms &args) {
+    // The output list is reused for every step and never grows past this.
+    this->outputValues_.reserve(CounterBank::MAX_COUNTERS);
+
+    if (args.empty()) {
+        this->setLengths({ DEFAULT_LENGTH });
+    } else {
+        this->setLengths(args);
+    }
+
+    this->applyLengths();
+};
+
+auto PolyCounterMax::setLengths(const atoms &lengths) -> void {
+    int count = std::clamp(static_cast<int>(lengths.size()), 1, static_cast<int>(CounterBank::MAX_COUNTERS));
+
+    for (int counter = 0; counter < count; counter++) {
+        int length = (counter < static_cast<int>(lengths.size())) ? static_cast<int>(lengths[counter]) : 1;
+        this->lengths_[counter].store(static_cast<uint32_t>(std::max(length, 1)), std::memory_order_relaxed);
+    }
+
+    this->count_.store(count, std::memory_order_relaxed);
+    this->lengthsChanged_.store(true, std::memory_order_release);
+}
+
+auto PolyCounterMax::setLength(int counter, int length) -> void {
+    if ((counter < 0) || (counter >= this->count_.load(std::memory_order_relaxed))) {
+        return;
+    }
+
+    this->lengths_[counter].store(static_cast<uint32_t>(std::max(length, 1)), std::memory_order_relaxed);
+    this->lengthsChanged_.store(true, std::memory_order_release);
+}
+
+auto PolyCounterMax::applyLengths() -> void {
+    if (!this->lengthsChanged_.exchange(false, std::memory_order_acquire)) {
+        return;
+    }
+
+    std::array<int, CounterBank::MAX_COUNTERS> values = {};
+    int count = this->count_.load(std::memory_order_relaxed);
+
+    for (int counter = 0; counter < count; counter++) {
+        values[counter] = static_cast<int>(this->lengths_[counter].load(std::memory_order_relaxed));
+    }
+
+    this->counters_.setLengths(values.data(), count);
+    this->outputValues_.resize(this->counters_.size());
+}
+
+auto PolyCounterMax::step() -> void {
+    this->applyLengths();
+
+    // The first bang after a reset only outputs the values.
+    if (this->alreadyBanged_) {
+        this->triggers_ = this->counters_.step();
+    } else {
+        this->alreadyBanged_ = true;
+        this->triggers_ = this->counters_.firstSteps();
+    }
+}
+
+void PolyCounterMax::handleOutputs() {
+    this->applyLengths();
+
+    for (int counter = 0; counter < this->counters_.size(); counter++) {
+        this->outputValues_[counter] = static_cast<int>(this->counters_.value(counter));
+    }
+
+    this->output_triggers.send(static_cast<long long>(this->triggers_));
+    this->output_values.send(this->outputValues_);
+}
+
+MIN_EXTERNAL(PolyCounterMax); // NOLINT
@@ -0,0 +1,106 @@
+/// @file       seidr.PolyCounter.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <c74_min.h>
+#include "CounterBank.hpp"
+
+using namespace c74::min;
+
+class PolyCounterMax : public object<PolyCounterMax> {
+public:
+    MIN_DESCRIPTION{"Counters with different lengths on one clock"}; // NOLINT 
+    MIN_TAGS{"seidr, counter"};                                      // NOLINT 
+    MIN_AUTHOR{"Jóhann Berentsson"};                                 // NOLINT 
+    MIN_RELATED{"seidr.*"};                                          // NOLINT 
+
+    enum : uint8_t {
+        DEFAULT_LENGTH = 8
+    };
+
+    explicit PolyCounterMax(const atoms &args = {});
+
+    void handleOutputs();
+    auto step() -> void;
+    auto setLengths(const atoms &lengths) -> void;
+    auto setLength(int counter, int length) -> void;
+    auto counterValue(int counter) -> unsigned int { return this->counters_.value(counter); }
+
+    // The lengths as they were last set, the counters take them over on
+    // the next step or output.
+    auto counterLength(int counter) -> unsigned int { return this->lengths_[counter].load(std::memory_order_relaxed); }
+    auto size() -> int { return this->count_.load(std::memory_order_relaxed); }
+    auto getTriggers() const -> uint64_t { return this->triggers_; }
+
+    inlet<> input0{this, "(bang) step every counter"};
+    inlet<> input1{this, "(reset | lengths | length) reset pulse"};
+
+    outlet<> output_values{this, "(list) value of each counter"};
+    outlet<> output_triggers{this, "(int) a bit for each counter that is on its first step"};
+
+    message<threadsafe::yes> bang {this, "bang", "Steps every counter.",
+        MIN_FUNCTION{
+            this->step();
+            this->handleOutputs();
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> reset {this, "reset", "Reset every counter.",
+        MIN_FUNCTION{
+            this->counters_.reset();
+            this->alreadyBanged_ = false;
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> output {this, "output", "Output the current values without changing them.",
+        MIN_FUNCTION{
+            this->handleOutputs();
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> lengths {this, "lengths", "Set the length of every counter, the number of lengths is the number of counters.",
+        MIN_FUNCTION{
+            if(!args.empty()){
+                this->setLengths(args);
+            }
+
+            return {};
+        }
+    };
+
+    message<threadsafe::yes> length {this, "length", "Set the length of a single counter.",
+        MIN_FUNCTION{
+            if(args.size() >= 2){
+                this->setLength(static_cast<int> (args[0]), static_cast<int> (args[1]));
+            }
+
+            return {};
+        }
+    };
+
+private:
+    auto applyLengths() -> void;
+
+    CounterBank counters_;
+    atoms outputValues_;
+
+    // Set by the length messages on any thread and taken over by the
+    // counters on the thread that steps them, so the counters and the
+    // output list are never resized while they are stepped or sent.
+    std::array<std::atomic<uint32_t>, CounterBank::MAX_COUNTERS> lengths_ {};
+    std::atomic<int> count_ {0};
+    std::atomic<bool> lengthsChanged_ {false};
+
+    uint64_t triggers_ = 0;
+    bool alreadyBanged_ = false;
+};
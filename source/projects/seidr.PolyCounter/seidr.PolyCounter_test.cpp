@@ -0,0 +1,96 @@
+/// @file       seidr.PolyCounter_test.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "seidr.PolyCounter.cpp" // NOLINT
+#include "seidr.PolyCounter.hpp"
+#include <c74_min_unittest.h>
+
+using namespace c74::max;
+
+SCENARIO("PolyCounterMax steps counters with different lengths") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("counters of length 2, 3 and 4") {
+        test_wrapper<PolyCounterMax> an_instance;
+        PolyCounterMax &myObject = an_instance;
+
+        myObject.lengths({ 2, 3, 4 }); // NOLINT
+
+        REQUIRE(myObject.size() == 3);
+        REQUIRE(myObject.counterLength(2) == 4);
+
+        auto &values = *object_getoutput(myObject, 0);
+        auto &triggers = *object_getoutput(myObject, 1);
+
+        WHEN("the first bang is sent") {
+            myObject.bang();
+
+            THEN("every counter is on its first step") {
+                REQUIRE(myObject.getTriggers() == 0x7); // NOLINT
+                REQUIRE(values.size() == 1);
+                REQUIRE(values[0].size() == 3);
+                REQUIRE(triggers.size() == 1);
+            }
+        }
+
+        WHEN("the counters are stepped") {
+            int expected[7][3] = { // NOLINT
+                {0, 0, 0},
+                {1, 1, 1},
+                {0, 2, 2},
+                {1, 0, 3},
+                {0, 1, 0},
+                {1, 2, 1},
+                {0, 0, 2}
+            };
+
+            uint64_t wraps[7] = {0x7, 0x0, 0x1, 0x2, 0x5, 0x0, 0x3}; // NOLINT
+
+            THEN("each counter wraps at its own length") {
+                for (int step = 0; step < 7; step++) { // NOLINT
+                    myObject.bang();
+
+                    for (int counter = 0; counter < 3; counter++) {
+                        REQUIRE(myObject.counterValue(counter) == expected[step][counter]);
+                        REQUIRE(values[step][counter] == expected[step][counter]);
+                    }
+
+                    REQUIRE(myObject.getTriggers() == wraps[step]);
+                }
+            }
+        }
+
+        WHEN("the counters are reset") {
+            myObject.bang();
+            myObject.bang();
+            myObject.reset();
+            myObject.bang();
+
+            THEN("they start over") {
+                for (int counter = 0; counter < 3; counter++) {
+                    REQUIRE(myObject.counterValue(counter) == 0);
+                }
+            }
+        }
+
+        WHEN("the lengths change between bangs") {
+            myObject.bang();
+            myObject.lengths({ 5, 6 }); // NOLINT
+            myObject.length({ 1, 7 }); // NOLINT
+
+            THEN("the counters take them over on the next bang") {
+                REQUIRE(myObject.size() == 2);
+                REQUIRE(myObject.counterLength(1) == 7);
+                REQUIRE(values[0].size() == 3);
+
+                myObject.bang();
+
+                REQUIRE(values[1].size() == 2);
+                REQUIRE(myObject.counterValue(1) == 1);
+            }
+        }
+    }
+}
@@ -0,0 +1,83 @@
+/// @file       BufferScale.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "QuantizerSettings.hpp"
+#include "Utils/MIDI.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A scale drawn in a buffer~.
+//
+// The buffer is read in place, frame by frame, and only when it has changed.
+// Every notification from the buffer~ bumps a change count, and the read on
+// the main thread compares it with the count the scale was last read at, so
+// a burst of edits is read once and the note path never touches the buffer.
+//
+// 12 frames are pitch classes, repeated in every octave, 128 frames are MIDI
+// notes. A frame above 0 puts its note in the scale.
+class BufferScale {
+public:
+    enum : uint8_t {
+        PITCH_CLASSES = 12,
+        NOTES = 128
+    };
+
+    // The settings slot the buffer writes to, 0 for the quantizer and 1-16
+    // for the channels, -1 when no buffer is bound.
+    auto bind(int slot) -> void {
+        this->slot_.store(static_cast<int8_t>(slot), std::memory_order_release);
+        this->touch();
+    }
+
+    auto unbind() -> void { this->slot_.store(-1, std::memory_order_release); }
+
+    // Read it once per read of the buffer, a bind can move it in between.
+    [[nodiscard]] auto slot() const -> int { return this->slot_.load(std::memory_order_acquire); }
+
+    // Any thread, called for every notification from the buffer~.
+    auto touch() -> void { this->changes_.fetch_add(1, std::memory_order_release); }
+
+    // The count of changes so far, taken before a read.
+    [[nodiscard]] auto changes() const -> uint32_t { return this->changes_.load(std::memory_order_acquire); }
+
+    // True when the scale has changed since the last read that went through.
+    [[nodiscard]] auto isChanged() const -> bool { return (this->slot() >= 0) && (this->changes() != this->read_); }
+
+    // The buffer was read at this change count. A read that fails isn't
+    // marked, so the scale is read again on the next try.
+    auto markRead(uint32_t changes) -> void { this->read_ = changes; }
+
+    // Reads the notes from anything with frame_count() and lookup(frame),
+    // false unless there are exactly 12 or 128 frames.
+    template <typename Buffer> static auto read(Buffer &buffer, QuantizerSettings &settings) -> bool {
+        size_t frames = buffer.frame_count();
+
+        if ((frames != PITCH_CLASSES) && (frames != NOTES)) {
+            return false;
+        }
+
+        bool pitchClasses = frames == PITCH_CLASSES;
+        settings.clear();
+
+        for (int note = 0; note < MIDI::KEYBOARD_SIZE; note++) {
+            size_t frame = pitchClasses ? static_cast<size_t>(note % PITCH_CLASSES) : static_cast<size_t>(note);
+
+            if (buffer.lookup(frame) > 0.0F) {
+                settings.addNote(note);
+            }
+        }
+
+        return true;
+    }
+
+private:
+    std::atomic<uint32_t> changes_ {0};
+    uint32_t read_ = 0;
+    std::atomic<int8_t> slot_ {-1};
+};
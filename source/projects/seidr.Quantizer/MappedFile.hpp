@@ -0,0 +1,132 @@
+/// @file       MappedFile.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read only memory mapping of a whole file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile &) = delete;
+    auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+    ~MappedFile() { this->close(); }
+
+    auto open(const std::string &path) -> bool {
+        this->close();
+
+#ifdef _WIN32
+        this->file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+        if (this->file_ == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+
+        if (!GetFileSizeEx(this->file_, &fileSize) || fileSize.QuadPart == 0) {
+            this->close();
+            return false;
+        }
+
+        this->mapping_ = CreateFileMappingA(this->file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+        if (this->mapping_ == nullptr) {
+            this->close();
+            return false;
+        }
+
+        this->data_ = static_cast<const char *>(MapViewOfFile(this->mapping_, FILE_MAP_READ, 0, 0, 0));
+        this->size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+        int fileDescriptor = ::open(path.c_str(), O_RDONLY);
+
+        if (fileDescriptor < 0) {
+            return false;
+        }
+
+        struct stat fileStat {};
+
+        if ((fstat(fileDescriptor, &fileStat) != 0) || (fileStat.st_size == 0)) {
+            ::close(fileDescriptor);
+            return false;
+        }
+
+        void *address = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+        ::close(fileDescriptor);
+
+        if (address == MAP_FAILED) {
+            return false;
+        }
+
+        this->data_ = static_cast<const char *>(address);
+        this->size_ = static_cast<size_t>(fileStat.st_size);
+#endif
+
+        if (this->data_ == nullptr) {
+            this->close();
+            return false;
+        }
+
+        return true;
+    }
+
+    auto close() -> void {
+#ifdef _WIN32
+        if (this->data_ != nullptr) {
+            UnmapViewOfFile(this->data_);
+        }
+
+        if (this->mapping_ != nullptr) {
+            CloseHandle(this->mapping_);
+        }
+
+        if (this->file_ != INVALID_HANDLE_VALUE) {
+            CloseHandle(this->file_);
+        }
+
+        this->mapping_ = nullptr;
+        this->file_ = INVALID_HANDLE_VALUE;
+#else
+        if (this->data_ != nullptr) {
+            munmap(const_cast<char *>(this->data_), this->size_); // NOLINT
+        }
+#endif
+        this->data_ = nullptr;
+        this->size_ = 0;
+    }
+
+    [[nodiscard]] auto data() const -> const char * { return this->data_; }
+    [[nodiscard]] auto size() const -> size_t { return this->size_; }
+    [[nodiscard]] auto isOpen() const -> bool { return this->data_ != nullptr; }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+
+#ifdef _WIN32
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#endif
+};
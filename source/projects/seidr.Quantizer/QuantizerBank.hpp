@@ -0,0 +1,111 @@
+/// @file       QuantizerBank.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "Quantizer/Quantizer.hpp"
+#include "QuantizerChannels.hpp"
+#include "QuantizerSettings.hpp"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// The quantizer for notes without a channel, the sixteen channel
+// quantizers and their settings.
+//
+// Notes are quantized while the scale is edited on another thread. There
+// are two sets, an edit copies the set notes are using into the other one,
+// changes it and publishes it with one index swap, so a note always reads
+// a whole set. Editing waits for notes still reading the set it reuses, a
+// note never waits.
+class QuantizerBank {
+public:
+    struct Quantizers {
+        Quantizer quantizer;
+        QuantizerChannels channels;
+
+        // Slot 0 is the quantizer, 1-16 the channels.
+        std::array<QuantizerSettings, QuantizerChannels::CHANNEL_COUNT + 1> settings = {};
+    };
+
+    QuantizerBank() {
+        for (auto &set : this->sets_) {
+            set.channels.update();
+        }
+    }
+
+    QuantizerBank(const QuantizerBank &) = delete;
+    auto operator=(const QuantizerBank &) -> QuantizerBank & = delete;
+
+    // Any thread, edits are applied one at a time.
+    template <typename Edit> auto edit(Edit edit) -> void {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        uint32_t current = this->current_.load();
+        uint32_t next = 1 - current;
+
+        while (this->readers_[next].load() != 0) {
+            std::this_thread::yield();
+        }
+
+        Quantizers &set = this->sets_[next];
+        set = this->sets_[current];
+        edit(set);
+        set.channels.update();
+        this->current_.store(next);
+    }
+
+    // Any thread, the set passed to read is not edited until read returns.
+    template <typename Read> auto read(Read read) -> decltype(auto) {
+        uint32_t index = this->current_.load();
+
+        // A set that was swapped out before this read was counted may be
+        // edited already, read the new one instead.
+        for (;;) {
+            this->readers_[index].fetch_add(1);
+            uint32_t current = this->current_.load();
+
+            if (current == index) {
+                break;
+            }
+
+            this->readers_[index].fetch_sub(1);
+            index = current;
+        }
+
+        Done done {this->readers_[index]};
+        return read(this->sets_[index]);
+    }
+
+    // Any thread, quantize a note without a channel.
+    auto quantize(int notePitch) -> int {
+        return this->read([notePitch](Quantizers &set) { return set.quantizer.quantize(MIDI::Note(notePitch)); });
+    }
+
+    // Any thread, quantize a note on a channel (0-15).
+    auto quantize(int channel, int notePitch) -> int {
+        return this->read([channel, notePitch](Quantizers &set) { return set.channels.quantize(channel, notePitch); });
+    }
+
+    // Any thread, whether a channel (0-15) has notes of its own.
+    auto hasNotes(int channel) -> bool {
+        return this->read([channel](Quantizers &set) { return set.settings[channel + 1].hasNotes(); });
+    }
+
+private:
+    // Lets go of the set when the read returns.
+    struct Done {
+        std::atomic<uint32_t> &readers;
+
+        ~Done() { this->readers.fetch_sub(1, std::memory_order_release); }
+    };
+
+    std::mutex mutex_;
+    std::array<Quantizers, 2> sets_;
+    std::atomic<uint32_t> current_ {0};
+    std::array<std::atomic<uint32_t>, 2> readers_ {};
+};
@@ -0,0 +1,73 @@
+/// @file       QuantizerChannels.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "Quantizer/Quantizer.hpp"
+#include "Utils/MIDI.hpp"
+#include <array>
+#include <cstdint>
+
+// Sixteen quantizers, one per MIDI channel.
+//
+// The note path only touches the lookup block: a 16 x 128 table of
+// quantized pitches that lives in one contiguous array. The Quantizer
+// instances only hold the configuration and are used to rebuild a
+// channel's row after it has been edited, update() rebuilds the rows so
+// quantizing never writes.
+class QuantizerChannels {
+public:
+    enum : uint8_t {
+        CHANNEL_COUNT = 16
+    };
+
+    static auto isValidChannel(int channel) -> bool {
+        return (channel >= 0) && (channel < CHANNEL_COUNT);
+    }
+
+    // Access a channel's quantizer for editing. The channel's lookup row is
+    // rebuilt on the next update().
+    auto edit(int channel) -> Quantizer & {
+        this->dirty_ |= static_cast<uint16_t>(1U << channel);
+        return this->quantizers_[channel];
+    }
+
+    [[nodiscard]] auto get(int channel) const -> const Quantizer & {
+        return this->quantizers_[channel];
+    }
+
+    [[nodiscard]] auto quantize(int channel, int notePitch) const -> int {
+        return this->table_[channel][notePitch];
+    }
+
+    // Rebuild the rows of the channels edited since the last update.
+    auto update() -> void {
+        for (int channel = 0; channel < CHANNEL_COUNT; channel++) {
+            if ((this->dirty_ >> channel) & 0x1) {
+                this->rebuild(channel);
+            }
+        }
+    }
+
+private:
+    auto rebuild(int channel) -> void {
+        auto &row = this->table_[channel];
+        auto &quantizer = this->quantizers_[channel];
+
+        for (int pitch = 0; pitch < MIDI::KEYBOARD_SIZE; pitch++) {
+            row[pitch] = static_cast<int16_t>(quantizer.quantize(MIDI::Note(pitch)));
+        }
+
+        this->dirty_ &= static_cast<uint16_t>(~(1U << channel));
+    }
+
+    // Hot: one row per channel, indexed by input pitch.
+    std::array<std::array<int16_t, MIDI::KEYBOARD_SIZE>, CHANNEL_COUNT> table_ = {};
+    uint16_t dirty_ = 0xFFFF;
+
+    // Cold: channel configuration.
+    std::array<Quantizer, CHANNEL_COUNT> quantizers_;
+};
@@ -0,0 +1,99 @@
+/// @file       QuantizerSettings.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "Quantizer/Quantizer.hpp"
+#include "Utils/MIDI.hpp"
+#include <array>
+#include <cstdint>
+
+// The settings made to one quantizer, kept next to it for state snapshots.
+//
+// A Quantizer can't list its notes, so every change made to it is also made
+// here. The struct is trivially copyable, a snapshot copies it as it is and
+// applyTo() rebuilds the quantizer from it. Only settings that have been
+// changed are applied, the others keep the quantizer's defaults.
+struct QuantizerSettings {
+    enum Changed : uint8_t {
+        MODE = 0x1,
+        ROUND = 0x2,
+        THROUGH = 0x4,
+        RANGE = 0x8
+    };
+
+    auto addNote(int note) -> void {
+        this->notes[note / 64] |= (uint64_t {1} << (note % 64)); // NOLINT
+    }
+
+    auto deleteNote(int note) -> void {
+        this->notes[note / 64] &= ~(uint64_t {1} << (note % 64)); // NOLINT
+    }
+
+    [[nodiscard]] auto hasNote(int note) const -> bool {
+        return ((this->notes[note / 64] >> (note % 64)) & 0x1) != 0; // NOLINT
+    }
+
+    [[nodiscard]] auto hasNotes() const -> bool { return (this->notes[0] | this->notes[1]) != 0; }
+
+    auto clear() -> void { this->notes = {}; }
+
+    auto setMode(int value) -> void {
+        this->mode = static_cast<int8_t>(value);
+        this->changed |= MODE;
+    }
+
+    auto setRound(int value) -> void {
+        this->round = static_cast<int8_t>(value);
+        this->changed |= ROUND;
+    }
+
+    auto setThrough(int value) -> void {
+        this->through = static_cast<int8_t>(value);
+        this->changed |= THROUGH;
+    }
+
+    auto setRange(int low, int high) -> void {
+        this->low = static_cast<int8_t>(low);
+        this->high = static_cast<int8_t>(high);
+        this->changed |= RANGE;
+    }
+
+    auto applyTo(Quantizer &quantizer) const -> void {
+        quantizer.clear();
+
+        for (int note = 0; note < MIDI::KEYBOARD_SIZE; note++) {
+            if (this->hasNote(note)) {
+                quantizer.addNote(MIDI::Note(note));
+            }
+        }
+
+        if ((this->changed & MODE) != 0) {
+            quantizer.setMode(Quantizer::QuantizeMode(this->mode));
+        }
+
+        if ((this->changed & ROUND) != 0) {
+            quantizer.setRoundDirection(Quantizer::RoundDirection(this->round));
+        }
+
+        if ((this->changed & THROUGH) != 0) {
+            quantizer.setThrough(Quantizer::NoteThrough(this->through));
+        }
+
+        if ((this->changed & RANGE) != 0) {
+            quantizer.setRange(MIDI::Note(this->low), MIDI::Note(this->high));
+        }
+    }
+
+    // One bit per MIDI note.
+    std::array<uint64_t, 2> notes = {};
+    int8_t mode = 0;
+    int8_t round = 0;
+    int8_t through = 0;
+    int8_t low = 0;
+    int8_t high = 0;
+    uint8_t changed = 0;
+};
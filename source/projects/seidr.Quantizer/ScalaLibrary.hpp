@@ -0,0 +1,612 @@
+/// @file       ScalaLibrary.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// A directory of Scala (.scl) scales, with optional keyboard mappings
+// (.kbm) that share the scale's file name.
+//
+// The directory is parsed once into a binary catalogue that is written
+// next to the scales and memory mapped. The catalogue is only rebuilt
+// when a file in the directory changes, so opening a library with
+// hundreds of scales does not parse any text. Every scale is stored with
+// a precomputed note and pitch bend table.
+//
+// The library is opened and searched on the main thread while notes read
+// the tunings found in it on any thread. Opening swaps in a new catalogue,
+// and the old one is only unmapped once no read can still be using it.
+class ScalaLibrary {
+public:
+    enum : uint16_t {
+        VERSION = 1,
+        KEYBOARD_SIZE = 128,
+        DEFAULT_ROOT = 60,
+        BEND_CENTER = 8192,
+        BEND_MAX = 16383,
+        BEND_RANGE_CENTS = 200,
+        MAX_DEGREES = 1024
+    };
+
+    enum TuningFlags : uint8_t {
+        MICROTONAL = 0x1
+    };
+
+    // Output for every input note, ready to be sent.
+    struct Tuning {
+        uint16_t pitchClasses;
+        uint8_t flags;
+        uint8_t root;
+        uint8_t note[KEYBOARD_SIZE];
+        uint16_t bend[KEYBOARD_SIZE];
+
+        [[nodiscard]] auto isMicrotonal() const -> bool { return (this->flags & MICROTONAL) != 0; }
+    };
+
+    struct Scale {
+        std::vector<double> cents; // Degrees after the unison, the last one is the period.
+        int root = DEFAULT_ROOT;
+        double offsetCents = 0.0;
+    };
+
+    static constexpr const char *CATALOGUE_NAME = ".seidr-scales.cat";
+
+    ScalaLibrary() = default;
+
+    ~ScalaLibrary() {
+        delete this->catalogue_.load(std::memory_order_relaxed);
+        this->reclaim(true);
+    }
+
+    ScalaLibrary(const ScalaLibrary &) = delete;
+    auto operator=(const ScalaLibrary &) -> ScalaLibrary & = delete;
+
+    // Main thread. Open a scale directory, rebuilding the catalogue if it is
+    // missing, out of date or damaged. A tuning found before is let go of
+    // by its reader first, see tune().
+    auto open(const std::string &directory) -> bool {
+        auto catalogue = std::make_unique<Catalogue>();
+
+        if (!load(*catalogue, directory)) {
+            this->replace(nullptr);
+            return false;
+        }
+
+        this->replace(catalogue.release());
+        return true;
+    }
+
+    // Main thread.
+    auto close() -> void { this->replace(nullptr); }
+
+    // Heap bytes of a catalogue that could not be written to the directory,
+    // a mapped catalogue is not counted. Any thread.
+    [[nodiscard]] auto bytes() const -> size_t {
+        this->readers_.fetch_add(1);
+        const Catalogue *catalogue = this->catalogue_.load();
+        size_t total = (catalogue != nullptr) ? catalogue->buffer.capacity() : 0;
+        this->readers_.fetch_sub(1, std::memory_order_release);
+        return total;
+    }
+
+    // Main thread, like open().
+    [[nodiscard]] auto size() const -> uint32_t {
+        const Catalogue *catalogue = this->catalogue_.load(std::memory_order_acquire);
+        return (catalogue != nullptr) ? catalogue->header->count : 0;
+    }
+
+    // Main thread, like open(). Find a scale by name, nullptr if there is no
+    // such scale. The tuning is valid until the next open() or close().
+    [[nodiscard]] auto find(const std::string &name) const -> const Tuning * {
+        const Catalogue *catalogue = this->catalogue_.load(std::memory_order_acquire);
+
+        if (catalogue == nullptr) {
+            return nullptr;
+        }
+
+        uint64_t hash = hashName(name);
+        const Entry *first = catalogue->entries;
+        const Entry *last = catalogue->entries + catalogue->header->count;
+        const Entry *entry = std::lower_bound(first, last, hash, [](const Entry &lhs, uint64_t rhs) { return lhs.hash < rhs; });
+
+        for (; (entry != last) && (entry->hash == hash); entry++) {
+            if ((entry->nameLength == name.size()) && (std::memcmp(catalogue->names + entry->nameOffset, name.data(), name.size()) == 0)) {
+                return &catalogue->tunings[entry->tuningIndex];
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Any thread. The note and pitch bend for a key in the tuning that the
+    // pointer holds, false when it holds none. The owner stores nullptr in
+    // it before it opens or closes the library, so the catalogue a tuning
+    // was found in isn't freed while it is read here.
+    auto tune(const std::atomic<const Tuning *> &selected, int key, int &note, int &bend) const -> bool {
+        this->readers_.fetch_add(1);
+        const Tuning *tuning = selected.load();
+        bool found = tuning != nullptr;
+
+        if (found) {
+            note = tuning->note[key];
+            bend = tuning->bend[key];
+        }
+
+        this->readers_.fetch_sub(1, std::memory_order_release);
+        return found;
+    }
+
+    // Parse the contents of a .scl file.
+    static auto parseScl(std::istream &input, Scale &scale) -> bool {
+        std::string line;
+        int lineNumber = 0;
+        long degreeCount = -1;
+
+        scale.cents.clear();
+
+        while (std::getline(input, line)) {
+            if (!line.empty() && line[0] == '!') {
+                continue;
+            }
+
+            lineNumber++;
+
+            // The first line is the description.
+            if (lineNumber == 1) {
+                continue;
+            }
+
+            std::istringstream tokens(line);
+            std::string token;
+
+            if (!(tokens >> token)) {
+                continue;
+            }
+
+            if (degreeCount < 0) {
+                degreeCount = std::strtol(token.c_str(), nullptr, 10);
+
+                if ((degreeCount <= 0) || (degreeCount > MAX_DEGREES)) {
+                    return false;
+                }
+
+                continue;
+            }
+
+            double cents = 0.0;
+
+            if (!parsePitch(token, cents)) {
+                return false;
+            }
+
+            scale.cents.push_back(cents);
+
+            if (static_cast<long>(scale.cents.size()) == degreeCount) {
+                break;
+            }
+        }
+
+        return (degreeCount > 0) && (static_cast<long>(scale.cents.size()) == degreeCount) && (scale.cents.back() > 0.0);
+    }
+
+    // Read the middle note and reference pitch of a .kbm file. The key
+    // mapping lines are not read.
+    static auto parseKbm(std::istream &input, Scale &scale) -> bool {
+        std::string line;
+        std::vector<double> fields;
+
+        while (std::getline(input, line) && fields.size() < 6) { // NOLINT
+            if (line.empty() || line[0] == '!') {
+                continue;
+            }
+
+            fields.push_back(std::strtod(line.c_str(), nullptr));
+        }
+
+        if (fields.size() < 6) { // NOLINT
+            return false;
+        }
+
+        int middleNote = static_cast<int>(fields[3]);
+        int referenceNote = static_cast<int>(fields[4]);
+        double referenceFrequency = fields[5];
+
+        if ((middleNote < 0) || (middleNote >= KEYBOARD_SIZE) || (referenceFrequency <= 0.0)) {
+            return false;
+        }
+
+        scale.root = middleNote;
+
+        // Detune relative to 12-TET at A = 440 Hz.
+        double equalFrequency = 440.0 * std::pow(2.0, (referenceNote - 69) / 12.0); // NOLINT
+        scale.offsetCents = 1200.0 * std::log2(referenceFrequency / equalFrequency); // NOLINT
+
+        return true;
+    }
+
+    // Map every key to a degree of the scale. Scales with up to 12 degrees
+    // are quantized, each key gets the nearest degree. Denser scales map
+    // consecutive keys to consecutive degrees like Scala does.
+    static auto buildTuning(const Scale &scale) -> Tuning {
+        Tuning tuning{};
+        double period = scale.cents.back();
+        auto degreeCount = static_cast<int>(scale.cents.size());
+        bool quantize = degreeCount <= 12; // NOLINT
+
+        tuning.root = static_cast<uint8_t>(scale.root);
+
+        for (int key = 0; key < KEYBOARD_SIZE; key++) {
+            double periods = 0.0;
+            double degree = 0.0;
+
+            if (quantize) {
+                double target = (key - scale.root) * 100.0; // NOLINT
+                periods = std::floor(target / period);
+                double remainder = target - (periods * period);
+
+                for (double cents : scale.cents) {
+                    if (std::abs(cents - remainder) < std::abs(degree - remainder)) {
+                        degree = cents;
+                    }
+                }
+            } else {
+                int steps = key - scale.root;
+                int index = ((steps % degreeCount) + degreeCount) % degreeCount;
+                periods = static_cast<double>((steps - index) / degreeCount);
+                degree = (index == 0) ? 0.0 : scale.cents[index - 1];
+            }
+
+            double absolute = (scale.root * 100.0) + (periods * period) + degree + scale.offsetCents; // NOLINT
+            auto nearest = static_cast<int>(std::lround(absolute / 100.0)); // NOLINT
+            int note = std::clamp(nearest, 0, KEYBOARD_SIZE - 1);
+
+            // A key whose pitch lands past the ends of the keyboard plays the
+            // first or last note, with the detune from the note it lands on.
+            double bendCents = absolute - (nearest * 100.0); // NOLINT
+            auto bend = static_cast<long>(std::lround(BEND_CENTER + (bendCents * BEND_CENTER / BEND_RANGE_CENTS)));
+
+            tuning.note[key] = static_cast<uint8_t>(note);
+            tuning.bend[key] = static_cast<uint16_t>(std::clamp(bend, 0L, static_cast<long>(BEND_MAX)));
+
+            if (std::abs(bendCents) >= 1.0) {
+                tuning.flags |= MICROTONAL;
+            }
+        }
+
+        // The pitch classes are only meaningful for quantized 12-tone scales.
+        if (quantize && (std::abs(period - 1200.0) < 1.0)) { // NOLINT
+            tuning.pitchClasses = 1U << (scale.root % 12); // NOLINT
+
+            for (double cents : scale.cents) {
+                auto semitones = static_cast<int>(std::lround((cents + scale.offsetCents) / 100.0)); // NOLINT
+                tuning.pitchClasses |= 1U << (((scale.root + semitones) % 12 + 12) % 12); // NOLINT
+            }
+        } else {
+            tuning.flags |= MICROTONAL;
+        }
+
+        return tuning;
+    }
+
+private:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;
+        uint64_t stamp;
+        uint32_t entriesOffset;
+        uint32_t tuningsOffset;
+        uint32_t namesOffset;
+        uint32_t size;
+    };
+
+    struct Entry {
+        uint64_t hash;
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t tuningIndex;
+        uint32_t reserved;
+    };
+
+    struct FileInfo {
+        std::string name;
+        uint64_t size;
+        int64_t modified;
+    };
+
+    // One opened catalogue, mapped from the directory or kept in memory.
+    struct Catalogue {
+        MappedFile file;
+        std::vector<char> buffer;
+
+        const Header *header = nullptr;
+        const Entry *entries = nullptr;
+        const Tuning *tunings = nullptr;
+        const char *names = nullptr;
+    };
+
+    static constexpr char MAGIC[8] = {'S', 'E', 'I', 'D', 'R', 'S', 'C', 'L'};
+
+    static auto hashName(const std::string &name) -> uint64_t {
+        uint64_t hash = 14695981039346656037ULL;
+
+        for (char character : name) {
+            hash ^= static_cast<uint8_t>(character);
+            hash *= 1099511628211ULL;
+        }
+
+        return hash;
+    }
+
+    static auto hasExtension(const std::string &name, const char *extension) -> bool {
+        size_t length = std::strlen(extension);
+        return (name.size() > length) && (name.compare(name.size() - length, length, extension) == 0);
+    }
+
+    static auto parsePitch(const std::string &token, double &cents) -> bool {
+        char *end = nullptr;
+
+        if (token.find('.') != std::string::npos) {
+            cents = std::strtod(token.c_str(), &end);
+            return end != token.c_str();
+        }
+
+        double numerator = std::strtod(token.c_str(), &end);
+        double denominator = 1.0;
+
+        if (*end == '/') {
+            denominator = std::strtod(end + 1, nullptr);
+        }
+
+        if ((numerator <= 0.0) || (denominator <= 0.0)) {
+            return false;
+        }
+
+        cents = 1200.0 * std::log2(numerator / denominator); // NOLINT
+        return true;
+    }
+
+    static auto listFiles(const std::string &directory) -> std::vector<FileInfo> {
+        std::vector<FileInfo> files;
+
+#ifdef _WIN32
+        WIN32_FIND_DATAA findData;
+        HANDLE search = FindFirstFileA((directory + "\\*").c_str(), &findData);
+
+        if (search == INVALID_HANDLE_VALUE) {
+            return files;
+        }
+
+        do {
+            std::string name = findData.cFileName;
+
+            if (hasExtension(name, ".scl") || hasExtension(name, ".kbm")) {
+                uint64_t size = (static_cast<uint64_t>(findData.nFileSizeHigh) << 32) | findData.nFileSizeLow; // NOLINT
+                int64_t modified = (static_cast<int64_t>(findData.ftLastWriteTime.dwHighDateTime) << 32) | findData.ftLastWriteTime.dwLowDateTime; // NOLINT
+                files.push_back({name, size, modified});
+            }
+        } while (FindNextFileA(search, &findData));
+
+        FindClose(search);
+#else
+        DIR *handle = opendir(directory.c_str());
+
+        if (handle == nullptr) {
+            return files;
+        }
+
+        while (const dirent *item = readdir(handle)) {
+            std::string name = item->d_name;
+            struct stat fileStat {};
+
+            if ((hasExtension(name, ".scl") || hasExtension(name, ".kbm")) && (stat((directory + "/" + name).c_str(), &fileStat) == 0)) {
+                files.push_back({name, static_cast<uint64_t>(fileStat.st_size), static_cast<int64_t>(fileStat.st_mtime)});
+            }
+        }
+
+        closedir(handle);
+#endif
+
+        std::sort(files.begin(), files.end(), [](const FileInfo &lhs, const FileInfo &rhs) { return lhs.name < rhs.name; });
+        return files;
+    }
+
+    static auto directoryStamp(const std::vector<FileInfo> &files) -> uint64_t {
+        std::string key;
+
+        for (const auto &file : files) {
+            key += file.name + ":" + std::to_string(file.size) + ":" + std::to_string(file.modified) + ";";
+        }
+
+        return hashName(key);
+    }
+
+    static auto buildCatalogue(const std::string &directory, const std::vector<FileInfo> &files, uint64_t stamp) -> std::vector<char> {
+        std::vector<Entry> entries;
+        std::vector<Tuning> tunings;
+        std::string names;
+
+        for (const auto &file : files) {
+            if (!hasExtension(file.name, ".scl")) {
+                continue;
+            }
+
+            std::string stem = file.name.substr(0, file.name.size() - 4); // NOLINT
+            std::ifstream sclFile(directory + "/" + file.name);
+            Scale scale;
+
+            if (!parseScl(sclFile, scale)) {
+                continue;
+            }
+
+            std::ifstream kbmFile(directory + "/" + stem + ".kbm");
+
+            if (kbmFile) {
+                parseKbm(kbmFile, scale);
+            }
+
+            entries.push_back({hashName(stem), static_cast<uint32_t>(names.size()), static_cast<uint32_t>(stem.size()), static_cast<uint32_t>(tunings.size()), 0});
+            tunings.push_back(buildTuning(scale));
+            names += stem;
+        }
+
+        std::sort(entries.begin(), entries.end(), [](const Entry &lhs, const Entry &rhs) { return lhs.hash < rhs.hash; });
+
+        Header header{};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.count = static_cast<uint32_t>(entries.size());
+        header.stamp = stamp;
+        header.entriesOffset = sizeof(Header);
+        header.tuningsOffset = header.entriesOffset + static_cast<uint32_t>(entries.size() * sizeof(Entry));
+        header.namesOffset = header.tuningsOffset + static_cast<uint32_t>(tunings.size() * sizeof(Tuning));
+        header.size = header.namesOffset + static_cast<uint32_t>(names.size());
+
+        std::vector<char> buffer(header.size);
+        std::memcpy(buffer.data(), &header, sizeof(Header));
+
+        // A directory without scales has an empty catalogue, and no data to copy.
+        if (!entries.empty()) {
+            std::memcpy(buffer.data() + header.entriesOffset, entries.data(), entries.size() * sizeof(Entry));
+            std::memcpy(buffer.data() + header.tuningsOffset, tunings.data(), tunings.size() * sizeof(Tuning));
+        }
+
+        std::memcpy(buffer.data() + header.namesOffset, names.data(), names.size());
+
+        return buffer;
+    }
+
+    static auto writeFile(const std::string &path, const std::vector<char> &buffer) -> bool {
+        std::string temporaryPath = path + ".tmp";
+
+        {
+            std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+
+            if (!output.write(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+                return false;
+            }
+        }
+
+        std::remove(path.c_str());
+        return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+    }
+
+    static auto load(Catalogue &catalogue, const std::string &directory) -> bool {
+        std::vector<FileInfo> files = listFiles(directory);
+        uint64_t stamp = directoryStamp(files);
+        std::string cataloguePath = directory + "/" + CATALOGUE_NAME;
+
+        if (catalogue.file.open(cataloguePath) && attach(catalogue, catalogue.file.data(), catalogue.file.size(), stamp)) {
+            return true;
+        }
+
+        catalogue.file.close();
+        catalogue.buffer = buildCatalogue(directory, files, stamp);
+
+        if (writeFile(cataloguePath, catalogue.buffer) && catalogue.file.open(cataloguePath) && attach(catalogue, catalogue.file.data(), catalogue.file.size(), stamp)) {
+            std::vector<char>().swap(catalogue.buffer);
+            return true;
+        }
+
+        // The directory is not writable, or on Windows the old catalogue is
+        // still mapped and can't be replaced, use the catalogue from memory.
+        catalogue.file.close();
+        return attach(catalogue, catalogue.buffer.data(), catalogue.buffer.size(), stamp);
+    }
+
+    // The file may have been damaged or written by something else, so
+    // every offset, count and index in it is checked against its size
+    // before anything points into it.
+    static auto attach(Catalogue &catalogue, const char *data, size_t size, uint64_t stamp) -> bool {
+        if ((data == nullptr) || (size < sizeof(Header))) {
+            return false;
+        }
+
+        const auto *header = reinterpret_cast<const Header *>(data); // NOLINT
+
+        if ((std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) || (header->version != VERSION) || (header->stamp != stamp) || (header->size != size)) {
+            return false;
+        }
+
+        uint64_t count = header->count;
+
+        if (!fits(header->entriesOffset, count * sizeof(Entry), alignof(Entry), size) ||
+            !fits(header->tuningsOffset, count * sizeof(Tuning), alignof(Tuning), size) ||
+            !fits(header->namesOffset, 0, 1, size)) {
+            return false;
+        }
+
+        const auto *entries = reinterpret_cast<const Entry *>(data + header->entriesOffset); // NOLINT
+        uint64_t namesSize = size - header->namesOffset;
+
+        for (uint64_t index = 0; index < count; index++) {
+            const Entry &entry = entries[index];
+
+            if ((entry.tuningIndex >= count) || (uint64_t{entry.nameOffset} + entry.nameLength > namesSize)) {
+                return false;
+            }
+        }
+
+        catalogue.header = header;
+        catalogue.entries = entries;
+        catalogue.tunings = reinterpret_cast<const Tuning *>(data + header->tuningsOffset); // NOLINT
+        catalogue.names = data + header->namesOffset;
+
+        return true;
+    }
+
+    // A region of the catalogue lies inside it, past the header and aligned
+    // for what it holds.
+    static auto fits(uint64_t offset, uint64_t length, size_t alignment, size_t size) -> bool {
+        return (offset >= sizeof(Header)) && (offset % alignment == 0) && (offset <= size) && (length <= size - offset);
+    }
+
+    auto replace(const Catalogue *catalogue) -> void {
+        const Catalogue *old = this->catalogue_.exchange(catalogue);
+
+        if (old != nullptr) {
+            this->retired_.push_back(old);
+        }
+
+        this->reclaim(false);
+    }
+
+    // Unmap the replaced catalogues once no note can be reading them.
+    auto reclaim(bool force) -> void {
+        if (!force && (this->readers_.load() != 0)) {
+            return;
+        }
+
+        for (const Catalogue *catalogue : this->retired_) {
+            delete catalogue;
+        }
+
+        this->retired_.clear();
+    }
+
+    std::atomic<const Catalogue *> catalogue_ {nullptr};
+    mutable std::atomic<uint32_t> readers_ {0};
+    std::vector<const Catalogue *> retired_;
+};
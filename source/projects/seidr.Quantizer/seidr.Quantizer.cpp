@@ -1,28 +1,88 @@
 #include <c74_min.h>
 #include "Quantizer/Quantizer.hpp"
 #include "seidr.Quantizer.hpp"
+#include <cmath>
 
 using namespace c74;
 
 QuantizerMax::QuantizerMax(const min::atoms &args) {
     if (!args.empty()) {
-        // QuantizeMode
-        if (!args.empty()) {
-            this->quantizer_.setMode(Quantizer::QuantizeMode(static_cast<int>(args[0])));
-        }
+        this->bank_.edit([&args](QuantizerBank::Quantizers &set) {
+            // QuantizeMode
+            if (!args.empty()) {
+                set.quantizer.setMode(Quantizer::QuantizeMode(static_cast<int>(args[0])));
+                set.settings[0].setMode(static_cast<int>(args[0]));
+            }
 
-        // RoundDirection
-        if (args.size() >= 2) {
-            this->quantizer_.setRoundDirection(Quantizer::RoundDirection(static_cast<int>(args[1])));
-        }
+            // RoundDirection
+            if (args.size() >= 2) {
+                set.quantizer.setRoundDirection(Quantizer::RoundDirection(static_cast<int>(args[1])));
+                set.settings[0].setRound(static_cast<int>(args[1]));
+            }
 
-        // Range
-        if (args.size() == 4) { 
-            uint8_t rangeLow = static_cast<int>(args[2]);
-            uint8_t rangeHigh = static_cast<int>(args[3]);
-            this->quantizer_.setRange(Quantizer::Note(rangeLow), Quantizer::Note(rangeHigh));
-        }
+            // Range
+            if (args.size() == 4) {
+                uint8_t rangeLow = static_cast<int>(args[2]);
+                uint8_t rangeHigh = static_cast<int>(args[3]);
+                set.quantizer.setRange(Quantizer::Note(rangeLow), Quantizer::Note(rangeHigh));
+                set.settings[0].setRange(rangeLow, rangeHigh);
+            }
+        });
+    }
+
+    // State saved with the patcher.
+    StateSnapshot::load(this->state(), this->slots_, [this](StateReader &reader) { return this->restore(reader); });
+}
+
+auto QuantizerMax::memoryUsage() const -> size_t {
+    return sizeof(*this) + this->scales_.bytes() + this->slots_.bytes() + this->recorder_.bytes();
+}
+
+auto QuantizerMax::snapshot() -> std::vector<uint8_t> {
+    auto settings = this->bank_.read([](QuantizerBank::Quantizers &set) { return set.settings; });
+
+    StateWriter writer(STATE_VERSION);
+    writer.writeArray(settings.data(), settings.size());
+    writer.write(this->editChannel_.load());
+    writer.write(this->hysteresis_.load());
+    writer.write(this->centsInput_.load());
+    writer.write(this->raw_.load());
+    return std::move(writer.bytes());
+}
+
+auto QuantizerMax::restore(StateReader &reader) -> bool {
+    std::array<QuantizerSettings, QuantizerChannels::CHANNEL_COUNT + 1> settings = {};
+    size_t count = 0;
+    uint8_t editChannel = 0;
+    double hysteresis = 0.0;
+    bool centsInput = false;
+    bool raw = false;
+
+    if ((reader.version() != STATE_VERSION) || !reader.readArray(settings.data(), settings.size(), count) ||
+        !reader.read(editChannel) || !reader.read(hysteresis) || !reader.read(centsInput) || !reader.read(raw)) {
+        return false;
     }
+
+    this->bank_.edit([&settings](QuantizerBank::Quantizers &set) {
+        set.settings = settings;
+        set.settings[0].applyTo(set.quantizer);
+
+        for (int channel = 0; channel < QuantizerChannels::CHANNEL_COUNT; channel++) {
+            set.settings[channel + 1].applyTo(set.channels.edit(channel));
+        }
+    });
+
+    this->editChannel_ = std::min<uint8_t>(editChannel, QuantizerChannels::CHANNEL_COUNT);
+    this->hysteresis_ = std::max(0.0, hysteresis);
+    this->lastFloatNote_ = -1;
+    this->centsInput_ = centsInput;
+    this->setRaw(raw);
+    this->tuning_ = nullptr;
+    return true;
+}
+
+auto QuantizerMax::recallSlot(int slot) -> bool {
+    return this->slots_.recall(slot, [this](StateReader &reader) { return this->restore(reader); });
 }
 
 auto QuantizerMax::processNoteMessage(int notePitch, int velocity) -> void { // NOLINT
@@ -31,8 +91,23 @@ auto QuantizerMax::processNoteMessage(int notePitch, int velocity) -> void { //
         return;
     }
     
+    // Microtonal scales have a precomputed note and pitch bend for every key.
+    int tunedNote = 0;
+    int bend = 0;
+
+    if (this->scales_.tune(this->tuning_, notePitch, tunedNote, bend)) {
+        output_bend.send(bend);
+
+        if (velocity <= MIDI::RANGE_HIGH) {
+            output_velocity.send(velocity);
+        }
+
+        output_note.send(tunedNote);
+        return;
+    }
+
     // Quantize the note.
-    int quantizedNote = this->quantizer_.quantize(MIDI::Note(notePitch));
+    int quantizedNote = this->bank_.quantize(notePitch);
     
     
     if (velocity <= MIDI::RANGE_HIGH) {
@@ -43,4 +118,239 @@ auto QuantizerMax::processNoteMessage(int notePitch, int velocity) -> void { //
     output_note.send(quantizedNote);
 }
 
+auto QuantizerMax::processChannelNoteMessage(int notePitch, int velocity, int channel) -> void { // NOLINT
+    // Validate input, channels are numbered 1-16.
+    if ((notePitch < MIDI::RANGE_LOW) || (notePitch > MIDI::RANGE_HIGH) || !QuantizerChannels::isValidChannel(channel - 1)) {
+        return;
+    }
+
+    // Quantize the note with the channel's lookup table.
+    int quantizedNote = this->bank_.quantize(channel - 1, notePitch);
+
+    output_channel.send(channel);
+
+    if (velocity <= MIDI::RANGE_HIGH) {
+        output_velocity.send(velocity);
+    }
+
+    // Send to outlets.
+    output_note.send(quantizedNote);
+}
+
+// Notes without a channel are tracked in slot 0, channels 1-16 in their own
+// slot. A slot of -1 is an invalid channel.
+template <typename Process> auto QuantizerMax::receive(int notePitch, int velocity, int slot, Process process) -> void {
+    // Invalid notes are rejected by the note functions.
+    if ((notePitch < MIDI::RANGE_LOW) || (notePitch > MIDI::RANGE_HIGH) || (slot < 0)) {
+        process();
+        return;
+    }
+
+    auto &shed = this->shedNotes_[slot];
+
+    // Note offs are never shed, unless their note on was.
+    if (velocity == 0) {
+        if (shed.test(notePitch)) {
+            shed.reset(notePitch);
+        } else {
+            process();
+        }
+
+        return;
+    }
+
+    // A note on that gets through owns the next note off again.
+    if (this->budget_.run(EventBudget::now(), process)) {
+        shed.reset(notePitch);
+    } else {
+        this->budget_.shed();
+        shed.set(notePitch);
+    }
+}
+
+auto QuantizerMax::receiveNote(int notePitch, int velocity) -> void {
+    this->receive(notePitch, velocity, 0, [this, notePitch, velocity] {
+        this->processNoteMessage(notePitch, velocity);
+    });
+}
+
+auto QuantizerMax::receiveNote(int notePitch, int velocity, int channel) -> void {
+    int slot = QuantizerChannels::isValidChannel(channel - 1) ? channel : -1;
+
+    this->receive(notePitch, velocity, slot, [this, notePitch, velocity, channel] {
+        this->processChannelNoteMessage(notePitch, velocity, channel);
+    });
+}
+
+auto QuantizerMax::receiveFloat(double notePitch) -> void {
+    bool sent = this->budget_.run(EventBudget::now(), [this, notePitch] {
+        // A newer value replaces one waiting from an earlier tick.
+        this->hasPendingFloat_.store(false, std::memory_order_relaxed);
+        this->processFloatMessage(notePitch);
+    });
+
+    if (!sent) {
+        this->budget_.shed();
+        this->pendingFloat_.store(notePitch, std::memory_order_relaxed);
+
+        if (!this->hasPendingFloat_.exchange(true, std::memory_order_release)) {
+            this->flush_tick.delay(0);
+        }
+    }
+}
+
+auto QuantizerMax::flush() -> void {
+    if (this->hasPendingFloat_.exchange(false, std::memory_order_acquire)) {
+        this->processFloatMessage(this->pendingFloat_.load(std::memory_order_relaxed));
+    }
+}
+
+auto QuantizerMax::setBudget(int events, int microseconds) -> void {
+    this->budget_.set(static_cast<uint32_t>(std::max(events, 0)), static_cast<uint32_t>(std::max(microseconds, 0)));
+}
+
+auto QuantizerMax::setRaw(bool raw) -> void {
+    this->raw_ = raw;
+    this->parser_.reset();
+}
+
+auto QuantizerMax::processRawByte(int byte) -> void {
+    MidiParser::Message message {};
+
+    if (!this->parser_.parse(byte, message)) {
+        return;
+    }
+
+    // Notes are quantized with the scale of their channel, everything else
+    // is passed through. A channel without notes of its own uses the scale
+    // for notes without a channel, and a microtonal Scala scale sends its
+    // pitch bend on the note's channel before a note on. A note quantized
+    // out of the MIDI range has no byte and is dropped.
+    if (message.isNote()) {
+        int channel = message.channel();
+        int quantizedNote = 0;
+        int bend = 0;
+
+        if (this->bank_.hasNotes(channel)) {
+            quantizedNote = this->bank_.quantize(channel, message.data1);
+        } else if (this->scales_.tune(this->tuning_, message.data1, quantizedNote, bend)) {
+            if (message.velocity() > 0) {
+                output_note.send(MidiParser::PITCH_BEND | channel);
+                output_note.send(bend & 0x7F); // NOLINT
+                output_note.send((bend >> 7) & 0x7F); // NOLINT
+            }
+        } else {
+            quantizedNote = this->bank_.quantize(message.data1);
+        }
+
+        if ((quantizedNote < MIDI::RANGE_LOW) || (quantizedNote > MIDI::RANGE_HIGH)) {
+            return;
+        }
+
+        message.data1 = static_cast<uint8_t>(quantizedNote);
+    }
+
+    output_note.send(message.status);
+
+    if (message.size > 1) {
+        output_note.send(message.data1);
+    }
+
+    if (message.size > 2) {
+        output_note.send(message.data2);
+    }
+}
+
+auto QuantizerMax::quantizeFloat(double notePitch) -> int {
+    auto nearest = static_cast<int>(std::lround(notePitch));
+    return this->bank_.quantize(std::clamp(nearest, MIDI::RANGE_LOW, MIDI::RANGE_HIGH));
+}
+
+auto QuantizerMax::processFloatMessage(double notePitch) -> void {
+    if (this->centsInput_) {
+        notePitch /= 100.0; // NOLINT
+    }
+
+    // Validate input.
+    if ((notePitch < MIDI::RANGE_LOW) || (notePitch > MIDI::RANGE_HIGH)) {
+        return;
+    }
+
+    int quantizedNote = this->quantizeFloat(notePitch);
+    int lastNote = this->lastFloatNote_;
+    double hysteresis = this->hysteresis_;
+
+    // Only send when the scale degree changes.
+    if (quantizedNote == lastNote) {
+        return;
+    }
+
+    // Hold the current degree until the input is past the boundary by more
+    // than the hysteresis band: moved back by the band, it must quantize to
+    // a degree past the held one. A band wider than a degree can step back
+    // over the held degree, so it is compared by direction.
+    if ((lastNote >= 0) && (hysteresis > 0.0)) {
+        bool up = quantizedNote > lastNote;
+        int towardLast = this->quantizeFloat(up ? notePitch - hysteresis : notePitch + hysteresis);
+
+        if (up ? (towardLast <= lastNote) : (towardLast >= lastNote)) {
+            return;
+        }
+    }
+
+    this->lastFloatNote_ = static_cast<int16_t>(quantizedNote);
+
+    // Send to outlets.
+    output_note.send(quantizedNote);
+}
+
+// The tuning is let go of before the library swaps its catalogue, so the
+// old one is freed as soon as no note is reading it.
+auto QuantizerMax::openScales(const std::string &directory) -> bool {
+    this->tuning_ = nullptr;
+    return this->scales_.open(directory);
+}
+
+auto QuantizerMax::selectScale(const std::string &name) -> bool {
+    const ScalaLibrary::Tuning *tuning = this->scales_.find(name);
+
+    if (tuning == nullptr) {
+        return false;
+    }
+
+    if (tuning->isMicrotonal()) {
+        this->tuning_ = tuning;
+        return true;
+    }
+
+    // 12-tone scales go through the quantizer so rounding and range apply.
+    this->tuning_ = nullptr;
+
+    this->editTarget([tuning](Quantizer &quantizer, QuantizerSettings &settings) {
+        quantizer.clear();
+        settings.clear();
+
+        for (int note = 0; note < MIDI::KEYBOARD_SIZE; note++) {
+            if ((tuning->pitchClasses >> (note % MIDI::OCTAVE)) & 0x1) {
+                quantizer.addNote(MIDI::Note(note));
+                settings.addNote(note);
+            }
+        }
+    });
+
+    return true;
+}
+
+auto QuantizerMax::bindBuffer(const std::string &name) -> void {
+    if (name.empty()) {
+        this->bufferScale_.unbind();
+        return;
+    }
+
+    // The scale is read on the main thread once the buffer~ is there.
+    this->buffer_.set(name);
+    this->bufferScale_.bind(this->editChannel_);
+    this->buffer_read.set();
+}
+
 MIN_EXTERNAL(QuantizerMax); // NOLINT
@@ -6,14 +6,112 @@
 
 #pragma once
 
+#include "BufferScale.hpp"
+#include "EventBudget.hpp"
+#include "MessageArgs.hpp"
+#include "MessageRecorder.hpp"
+#include "MidiParser.hpp"
 #include "Quantizer/Quantizer.hpp"
+#include "QuantizerBank.hpp"
+#include "QuantizerChannels.hpp"
+#include "QuantizerSettings.hpp"
+#include "ScalaLibrary.hpp"
+#include "StateSnapshot.hpp"
+#include <algorithm>
+#include <atomic>
+#include <bitset>
 #include <c74_min.h>
+#include <string>
 
 using namespace c74;
 
 class QuantizerMax : public min::object<QuantizerMax> {
 private:
-    Quantizer quantizer_;
+    // The quantizers and their settings, edited by configuration messages
+    // while notes are quantized on any thread.
+    QuantizerBank bank_;
+    std::atomic<uint8_t> editChannel_ {0};
+
+    // Float input.
+    std::atomic<double> hysteresis_ {0.0};
+    std::atomic<int16_t> lastFloatNote_ {-1};
+    std::atomic<bool> centsInput_ {false};
+
+    // Scala scales. The tuning is selected on the main thread and read by
+    // notes on any thread.
+    ScalaLibrary scales_;
+    std::atomic<const ScalaLibrary::Tuning *> tuning_ {nullptr};
+
+    // A scale drawn in a buffer~, read again only after it changes.
+    BufferScale bufferScale_;
+
+    // Raw mode, MIDI bytes in and out.
+    MidiParser parser_;
+    std::atomic<bool> raw_ {false};
+
+    MessageRecorder recorder_;
+    StateSlots<> slots_;
+
+    // Overload protection. Note ons over the budget are dropped and their
+    // note offs with them, float input over the budget only keeps the last
+    // value and sends it on the next tick.
+    EventBudget budget_;
+    std::array<std::bitset<MIDI::KEYBOARD_SIZE>, QuantizerChannels::CHANNEL_COUNT + 1> shedNotes_;
+    std::atomic<double> pendingFloat_ {0.0};
+    std::atomic<bool> hasPendingFloat_ {false};
+
+    auto quantizeFloat(double notePitch) -> int;
+
+    // Reads the scale into the settings of the slot the buffer~ was bound
+    // for and applies it, the change count is marked read once it went
+    // through.
+    template <typename Buffer> auto readBuffer(Buffer &buffer, int slot, uint32_t changes) -> void {
+        bool read = false;
+
+        this->bank_.edit([&buffer, slot, &read](QuantizerBank::Quantizers &set) {
+            auto &settings = set.settings[slot];
+            read = BufferScale::read(buffer, settings);
+
+            if (read) {
+                settings.applyTo((slot == 0) ? set.quantizer : set.channels.edit(slot - 1));
+            }
+        });
+
+        if (!read) {
+            max::object_error((max::t_object*) this, "a scale buffer~ needs 12 or 128 frames");
+            return;
+        }
+
+        this->bufferScale_.markRead(changes);
+        this->lastFloatNote_ = -1;
+
+        if (slot == 0) {
+            this->tuning_ = nullptr;
+        }
+    }
+
+    template <typename Process> auto receive(int notePitch, int velocity, int slot, Process process) -> void;
+
+    // The quantizer that configuration messages apply to, for reading. Only
+    // editTarget marks a channel's row for a rebuild.
+    auto target(const QuantizerBank::Quantizers &set) const -> const Quantizer & {
+        int channel = this->editChannel_;
+        return (channel == 0) ? set.quantizer : set.channels.get(channel - 1);
+    }
+
+    // Edit the quantizer that configuration messages apply to and its
+    // settings. Every edit goes through here, and the held float degree
+    // belongs to the old scale, so the next float is sent whatever it
+    // quantizes to.
+    template <typename Edit> auto editTarget(Edit edit) -> void {
+        int channel = this->editChannel_;
+
+        this->bank_.edit([channel, &edit](QuantizerBank::Quantizers &set) {
+            edit((channel == 0) ? set.quantizer : set.channels.edit(channel - 1), set.settings[channel]);
+        });
+
+        this->lastFloatNote_ = -1;
+    }
 
 public:
     MIN_DESCRIPTION{"Quantize a MIDI note message."}; // NOLINT
@@ -26,45 +124,116 @@ public:
         ARGS = 1
     };
 
+    enum : uint16_t {
+        STATE_VERSION = 1
+    };
+
     using RoundDirection = Quantizer::RoundDirection;
     using QuantizeMode = Quantizer::QuantizeMode;
     using NoteThrough = Quantizer::NoteThrough;
 
     explicit QuantizerMax(const min::atoms &args = {});
 
-    auto noteCount() -> int { return this->quantizer_.noteCount(); }
-    auto getRoundDirection() -> RoundDirection { return this->quantizer_.getRoundDirection(); }
+    auto noteCount() -> int {
+        return this->bank_.read([this](const QuantizerBank::Quantizers &set) { return this->target(set).noteCount(); });
+    }
+
+    auto getRoundDirection() -> RoundDirection {
+        return this->bank_.read([this](const QuantizerBank::Quantizers &set) { return this->target(set).getRoundDirection(); });
+    }
+
+    auto getEditChannel() const -> int { return this->editChannel_; }
     auto processNoteMessage(int notePitch, int velocity) -> void;
+    auto processChannelNoteMessage(int notePitch, int velocity, int channel) -> void;
+    auto processFloatMessage(double notePitch) -> void;
+    auto receiveNote(int notePitch, int velocity) -> void;
+    auto receiveNote(int notePitch, int velocity, int channel) -> void;
+    auto receiveFloat(double notePitch) -> void;
+    auto flush() -> void;
+    auto setBudget(int events, int microseconds) -> void;
+    auto shedCount() const -> uint64_t { return this->budget_.shedCount(); }
+    auto getHysteresis() const -> double { return this->hysteresis_.load(std::memory_order_relaxed); }
+    auto openScales(const std::string &directory) -> bool;
+    auto selectScale(const std::string &name) -> bool;
+    auto bindBuffer(const std::string &name) -> void;
+    auto isBufferBound() const -> bool { return this->bufferScale_.slot() >= 0; }
+
+    // Main thread, reads the buffer~ if it changed since the last read. The
+    // tests pass a mocked buffer_lock.
+    template <typename Lock = min::buffer_lock<false>> auto syncBuffer() -> void {
+        if (!this->bufferScale_.isChanged()) {
+            return;
+        }
+
+        int slot = this->bufferScale_.slot();
+        uint32_t changes = this->bufferScale_.changes();
+
+        if (slot < 0) {
+            return;
+        }
+
+        Lock buffer(this->buffer_);
+
+        // A buffer~ that doesn't exist yet is read when it is created.
+        if (buffer.valid()) {
+            this->readBuffer(buffer, slot, changes);
+        }
+    }
+    auto scaleCount() const -> uint32_t { return this->scales_.size(); }
+    auto isMicrotonal() const -> bool { return this->tuning_ != nullptr; }
+    auto setRaw(bool raw) -> void;
+    auto isRaw() const -> bool { return this->raw_; }
+    auto processRawByte(int byte) -> void;
+
+    auto memoryUsage() const -> size_t;
+
+    // State snapshots.
+    auto snapshot() -> std::vector<uint8_t>;
+    auto restore(StateReader &reader) -> bool;
+    auto recallSlot(int slot) -> bool;
 
     // Inlets
-    min::inlet<> input_note       {this, "(list) note and velocity"};
-    min::inlet<> input_arguments  {this, "(add|remove|update|mode|round|clear|through) input arguments"};
+    min::inlet<> input_note       {this, "(list) note, velocity and optional channel"};
+    min::inlet<> input_arguments  {this, "(add|remove|update|mode|round|clear|through|channel|scales|scale|buffer|raw|store|recall|budget) input arguments"};
 
     // Outlets
     min::outlet<> output_note     {this, "(anything) output note"};
     min::outlet<> output_velocity {this, "(anything) output velocity"};
     min::outlet<> output_invalid  {this, "(bang) note was not playaed"};
+    min::outlet<> output_channel  {this, "(int) output channel"};
+    min::outlet<> output_bend     {this, "(int) output pitch bend for microtonal scales"};
 
     min::message<min::threadsafe::yes> anything {
         this, "anything", "Handle any input",
         MIN_FUNCTION {
-            max::object_post((max::t_object*)this, "anything\n");
+            this->recorder_.record(inlet, "anything", args);
+
             return {};
         }
     };
 
     min::message<min::threadsafe::yes> integerInput {
-        this, "int", "Handle integer input",
+        this, "int", "MIDI byte in raw mode",
         MIN_FUNCTION {
-            max::object_post((max::t_object*)this, "int\n");
+            this->recorder_.record(inlet, "int", args);
+
+            if (Inlets(inlet) == Inlets::NOTE && this->raw_ && !args.empty()) {
+                this->processRawByte(static_cast<int>(args[0]));
+            }
+
             return {};
         }
     };
 
     min::message<min::threadsafe::yes> floatInput {
-        this, "float", "Handle float input",
+        this, "float", "Quantize a fractional note pitch",
         MIN_FUNCTION {
-            max::object_post((max::t_object*)this, "float\n");
+            this->recorder_.record(inlet, "float", args);
+
+            if (Inlets(inlet) == Inlets::NOTE && !args.empty()) {
+                this->receiveFloat(static_cast<double>(args[0]));
+            }
+
             return {};
         }
     };
@@ -72,7 +241,8 @@ public:
     min::message<min::threadsafe::yes> bangInput {
         this, "bang", "Handle bang input",
         MIN_FUNCTION {
-            max::object_post((max::t_object*)this, "bang\n");
+            this->recorder_.record(inlet, "bang", args);
+
             return {};
         }
     };
@@ -80,12 +250,17 @@ public:
     min::message<min::threadsafe::yes> list {
         this, "list", "Process note messages",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "list\n");
-            
-            if (Inlets(inlet) == Inlets::NOTE && args.size() >= 2) {
+            this->recorder_.record(inlet, "list", args);
+
+            if (Inlets(inlet) == Inlets::NOTE && args.size() >= 3) {
                 int note = static_cast<int>(args[0]);
                 int velocity = static_cast<int>(args[1]);
-                this->processNoteMessage(note, velocity);
+                int channel = static_cast<int>(args[2]);
+                this->receiveNote(note, velocity, channel);
+            } else if (Inlets(inlet) == Inlets::NOTE && args.size() >= 2) {
+                int note = static_cast<int>(args[0]);
+                int velocity = static_cast<int>(args[1]);
+                this->receiveNote(note, velocity);
             }
             
             return {};
@@ -95,15 +270,18 @@ public:
     min::message<min::threadsafe::yes> quantizerAddNote {
         this, "add", "Add notes to quantizer",
         MIN_FUNCTION {
-            max::object_post((max::t_object*)this, "add\n");
-            
+            this->recorder_.record(inlet, "add", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                for (const auto &arg : args) {
-                    int note = static_cast<int>(arg);
-                    if((note >= MIDI::RANGE_LOW) && (note <= MIDI::RANGE_HIGH) ) {
-                        this->quantizer_.addNote(MIDI::Note(note));
+                this->editTarget([&args](Quantizer &quantizer, QuantizerSettings &settings) {
+                    for (const auto &arg : args) {
+                        int note = 0;
+                        if (MessageArgs::readNote(arg, note)) {
+                            quantizer.addNote(MIDI::Note(note));
+                            settings.addNote(note);
+                        }
                     }
-                }                
+                });
             }
             
             return {};
@@ -113,11 +291,20 @@ public:
     min::message<min::threadsafe::yes> quantizerThrough {
         this, "through", "Disable note through.",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "through\n");
-            
+            this->recorder_.record(inlet, "through", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                int quantizeFlag = static_cast<int>(args[0]);
-                this->quantizer_.setThrough(NoteThrough(quantizeFlag));
+                int quantizeFlag = 0;
+
+                if (!MessageArgs::readInt(args[0], quantizeFlag) || (quantizeFlag < static_cast<int>(NoteThrough::OFF)) || (quantizeFlag > static_cast<int>(NoteThrough::ON))) {
+                    max::object_error((max::t_object*) this, "through needs 0 or 1");
+                    return {};
+                }
+
+                this->editTarget([quantizeFlag](Quantizer &quantizer, QuantizerSettings &settings) {
+                    quantizer.setThrough(NoteThrough(quantizeFlag));
+                    settings.setThrough(quantizeFlag);
+                });
             }
             
             return {};
@@ -127,14 +314,21 @@ public:
     min::message<min::threadsafe::yes> updateNotes {
         this, "update", "Clears all notes",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "update\n");
+            this->recorder_.record(inlet, "update", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                this->quantizer_.clear();
-                
-                for (const auto &argValue : args) {
-                    int noteValue = static_cast<int>(argValue);
-                    this->quantizer_.addNote(MIDI::Note(noteValue));
-                }
+                this->editTarget([&args](Quantizer &quantizer, QuantizerSettings &settings) {
+                    quantizer.clear();
+                    settings.clear();
+
+                    for (const auto &argValue : args) {
+                        int noteValue = 0;
+                        if (MessageArgs::readNote(argValue, noteValue)) {
+                            quantizer.addNote(MIDI::Note(noteValue));
+                            settings.addNote(noteValue);
+                        }
+                    }
+                });
             }
 
             return {};
@@ -144,10 +338,13 @@ public:
     min::message<min::threadsafe::yes> quantizerClear {
         this, "clear", "Clear notes from the quantizer.",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "clear\n");
-            
+            this->recorder_.record(inlet, "clear", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                    this->quantizer_.clear();
+                this->editTarget([](Quantizer &quantizer, QuantizerSettings &settings) {
+                    quantizer.clear();
+                    settings.clear();
+                });
             }
 
             return {};
@@ -157,15 +354,22 @@ public:
     min::message<min::threadsafe::yes> quantizerMode {
         this, "mode", "Set quantizer mode.",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "mode\n");
-            
+            this->recorder_.record(inlet, "mode", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                for (const auto &arg : args) {
-                    int modeFlag = static_cast<int>(arg);
-                    this->quantizer_.setMode(QuantizeMode(modeFlag));
-                }                
+                int modeFlag = 0;
+
+                if (!MessageArgs::readInt(args[0], modeFlag) || (modeFlag < static_cast<int>(QuantizeMode::ALL_NOTES)) || (modeFlag > static_cast<int>(QuantizeMode::TWELVE_NOTES))) {
+                    max::object_error((max::t_object*) this, "mode needs 0 or 1");
+                    return {};
+                }
+
+                this->editTarget([modeFlag](Quantizer &quantizer, QuantizerSettings &settings) {
+                    quantizer.setMode(QuantizeMode(modeFlag));
+                    settings.setMode(modeFlag);
+                });
             }
-            
+
             return {};
         }
     };
@@ -173,15 +377,22 @@ public:
     min::message<min::threadsafe::yes> quantizerRound {
         this, "round", "Set quantizer mode.",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "round\n");
-            
+            this->recorder_.record(inlet, "round", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                for (const auto &arg : args) {
-                    int modeFlag = static_cast<int>(arg);
-                    this->quantizer_.setRoundDirection(RoundDirection(modeFlag));
+                int modeFlag = 0;
+
+                if (!MessageArgs::readInt(args[0], modeFlag) || (modeFlag < static_cast<int>(RoundDirection::UP)) || (modeFlag > static_cast<int>(RoundDirection::FURTHEST))) {
+                    max::object_error((max::t_object*) this, "round needs a rounding mode 0-7");
+                    return {};
                 }
+
+                this->editTarget([modeFlag](Quantizer &quantizer, QuantizerSettings &settings) {
+                    quantizer.setRoundDirection(RoundDirection(modeFlag));
+                    settings.setRound(modeFlag);
+                });
             }
-            
+
             return {};
         }
     };
@@ -189,24 +400,280 @@ public:
     min::message<min::threadsafe::yes> quantizerRange {
         this, "range", "Set quantizer range.",
         MIN_FUNCTION {
-            if (Inlets(inlet) == Inlets::ARGS && !args.empty() && args.size() >= 2) {
-                auto low = MIDI::Note(static_cast<int>(args[0]));
-                auto high = MIDI::Note(static_cast<int>(args[1]));
-                this->quantizer_.setRange(low, high);
+            this->recorder_.record(inlet, "range", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int low = 0;
+                int high = 0;
+
+                if ((args.size() < 2) || !MessageArgs::readNote(args[0], low) || !MessageArgs::readNote(args[1], high)) {
+                    max::object_error((max::t_object*) this, "range needs a low and a high note");
+                    return {};
+                }
+
+                this->editTarget([low, high](Quantizer &quantizer, QuantizerSettings &settings) {
+                    quantizer.setRange(MIDI::Note(low), MIDI::Note(high));
+                    settings.setRange(low, high);
+                });
             }
             
             return {};
         }
     };
 
+    min::message<min::threadsafe::yes> quantizerChannel {
+        this, "channel", "Select the MIDI channel (1-16) that settings apply to, 0 for notes without a channel.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "channel", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int channel = static_cast<int>(args[0]);
+
+                if ((channel == 0) || QuantizerChannels::isValidChannel(channel - 1)) {
+                    this->editChannel_ = static_cast<uint8_t>(channel);
+                }
+            }
+
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerHysteresis {
+        this, "hysteresis", "Set the hysteresis band for float input in semitones.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "hysteresis", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                this->hysteresis_ = std::max(0.0, static_cast<double>(args[0]));
+            }
+
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerCents {
+        this, "cents", "Interpret float input as cents instead of MIDI pitch.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "cents", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                this->centsInput_ = static_cast<int>(args[0]) != 0;
+            }
+
+            return {};
+        }
+    };
+
+    min::message<> quantizerScales {
+        this, "scales", "Open a directory of Scala scales.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "scales", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                std::string directory = args[0];
+
+                if (!this->openScales(directory)) {
+                    max::object_error((max::t_object*) this, "could not open scales in %s", directory.c_str());
+                }
+            }
+
+            return {};
+        }
+    };
+
+    min::message<> quantizerScale {
+        this, "scale", "Use a scale from the Scala library, no argument to turn it off.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "scale", args);
+
+            if (Inlets(inlet) == Inlets::ARGS) {
+                if (args.empty()) {
+                    this->tuning_ = nullptr;
+                } else {
+                    std::string name = args[0];
+
+                    if (!this->selectScale(name)) {
+                        max::object_error((max::t_object*) this, "no scale named %s", name.c_str());
+                    }
+                }
+            }
+
+            return {};
+        }
+    };
+
+    min::message<> quantizerBuffer {
+        this, "buffer", "Read the scale from a buffer~ of 12 or 128 frames when it changes, no argument to stop.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "buffer", args);
+
+            if (Inlets(inlet) == Inlets::ARGS) {
+                this->bindBuffer(args.empty() ? std::string() : std::string(args[0]));
+            }
+
+            return {};
+        }
+    };
+
+    // The buffer~ is read and the settings written on the main thread, like
+    // the scales and buffer messages, never on the note path.
+    min::queue<> buffer_read {
+        this, MIN_FUNCTION {
+            this->syncBuffer();
+            return {};
+        }
+    };
+
+    // Binding, unbinding and every edit of the buffer~ are changes.
+    min::buffer_reference buffer_ {
+        this, MIN_FUNCTION {
+            this->bufferScale_.touch();
+            this->buffer_read.set();
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> quantizerRaw {
+        this, "raw", "Read and send raw MIDI bytes instead of note velocity lists.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "raw", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                this->setRaw(static_cast<int>(args[0]) != 0);
+            }
+
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> budget {
+        this, "budget", "Notes and microseconds per scheduler tick, note ons over it are dropped. No arguments turns it off.",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "budget", args);
+
+            if (Inlets(inlet) == Inlets::ARGS) {
+                int events = 0;
+                int microseconds = 0;
+
+                if (!MessageArgs::readOptionalInts(args, events, microseconds)) {
+                    max::object_error((max::t_object*) this, "budget needs a number of notes and microseconds");
+                    return {};
+                }
+
+                this->setBudget(events, microseconds);
+            }
+
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> shed {
+        this, "shed", "Post the number of inputs dropped or merged to stay in the budget.",
+        MIN_FUNCTION {
+            max::object_post((max::t_object*) this, "%llu shed", static_cast<unsigned long long>(this->shedCount()));
+            return {};
+        }
+    };
+
+    // Coalesced float input, sent on the next tick.
+    min::timer<> flush_tick {
+        this, MIN_FUNCTION {
+            this->flush();
+            return {};
+        }
+    };
+
+    min::message<> store {
+        this, "store", "Store the state in a slot (0-15).",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "store", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    max::object_error((max::t_object*) this, "store needs a slot number");
+                    return {};
+                }
+
+                this->slots_.store(slot, this->snapshot());
+            }
+
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> recall {
+        this, "recall", "Recall the state stored in a slot (0-15).",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "recall", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    max::object_error((max::t_object*) this, "recall needs a slot number");
+                    return {};
+                }
+
+                this->recallSlot(slot);
+            }
+
+            return {};
+        }
+    };
+
+    min::message<> savestate {
+        this, "savestate", "Save the state and the slots with the patcher.",
+        MIN_FUNCTION {
+            min::dict state {args[0]};
+            StateSnapshot::save(state, this->snapshot(), this->slots_);
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> memory {
+        this, "memory", "Post the number of bytes used by this instance",
+        MIN_FUNCTION {
+            max::object_post((max::t_object*) this, "%zu bytes", this->memoryUsage());
+            return {};
+        }
+    };
+
+    min::message<> record {
+        this, "record", "Record every message to a file, no argument stops recording",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS) {
+                if (args.empty()) {
+                    this->recorder_.close();
+                } else {
+                    std::string path = args[0];
+
+                    if (!this->recorder_.open(path)) {
+                        max::object_error((max::t_object*) this, "could not record to %s", path.c_str());
+                    }
+                }
+            }
+
+            return {};
+        }
+    };
+
     min::message<min::threadsafe::yes> quantizerDeleteNote {
         this, "delete", "Delete notes from quantizer",
         MIN_FUNCTION {
-            max::object_post((max::t_object*) this, "delete\n");
+            this->recorder_.record(inlet, "delete", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()){
-                for(const auto &arg : args){
-                    this->quantizer_.deleteNote(MIDI::Note(static_cast<int>(arg)));
-                }
+                this->editTarget([&args](Quantizer &quantizer, QuantizerSettings &settings) {
+                    for (const auto &arg : args) {
+                        int note = 0;
+                        if (MessageArgs::readNote(arg, note)) {
+                            quantizer.deleteNote(MIDI::Note(note));
+                            settings.deleteNote(note);
+                        }
+                    }
+                });
             }
             return {};
         }
@@ -7,6 +7,10 @@
 #include "seidr.Quantizer.cpp" // NOLINT
 #include "seidr.Quantizer.hpp"
 #include <c74_min_unittest.h>
+#include "StressRunner.hpp"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
 
 using namespace c74;
 using namespace MIDI::Notes;
@@ -50,6 +54,11 @@ SCENARIO("quantizer can add notes") {
             REQUIRE_NOTHROW(quantizerTestObject.quantizerAddNote({ NoteC4, NoteE4, NoteG4 }, 1));
             REQUIRE(quantizerTestObject.noteCount() == 3);
         }
+
+        WHEN("adding notes by name") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerAddNote({ "C4", "Eb4", "G4", "nope" }, 1));
+            REQUIRE(quantizerTestObject.noteCount() == 3);
+        }
     }
 }
 
@@ -127,6 +136,16 @@ SCENARIO("quantizer handles round directions") {
             REQUIRE_NOTHROW(quantizerTestObject.quantizerRound(RoundDirection::DOWN, Inlets::ARGS));
             REQUIRE(quantizerTestObject.getRoundDirection() == RoundDirection::DOWN);
         }
+
+        WHEN("round gets something that isn't a rounding mode") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerRound(RoundDirection::DOWN, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerRound({ "sideways" }, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerRound(8, Inlets::ARGS)); // NOLINT
+
+            THEN("it is rejected and the direction is kept") {
+                REQUIRE(quantizerTestObject.getRoundDirection() == RoundDirection::DOWN);
+            }
+        }
     }
 }
 
@@ -378,3 +397,774 @@ SCENARIO("updating the quantized notes") { // NOLINT
         }
     }
 }
+
+SCENARIO("quantizing notes per MIDI channel") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    GIVEN("two channels with different scales") {
+        auto &note_output = *max::object_getoutput(quantizerTestObject, 0);
+        auto &channel_output = *max::object_getoutput(quantizerTestObject, 3);
+
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(1, Inlets::ARGS));
+        REQUIRE(quantizerTestObject.getEditChannel() == 1);
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerMode(QuantizeMode::ALL_NOTES, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteC5, NoteE5 }, Inlets::ARGS));
+        REQUIRE(quantizerTestObject.noteCount() == 2);
+
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(2, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerMode(QuantizeMode::ALL_NOTES, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteD5, NoteG5 }, Inlets::ARGS));
+        REQUIRE(quantizerTestObject.noteCount() == 2);
+
+        WHEN("notes are sent with a channel") {
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteDS5, 100, 1 }, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteDS5, 100, 2 }, Inlets::NOTE)); // NOLINT
+
+            THEN("each channel uses its own scale") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(note_output[0][1] == NoteE5);
+                REQUIRE(note_output[1][1] == NoteG5);
+                REQUIRE(channel_output[0][1] == 1);
+                REQUIRE(channel_output[1][1] == 2);
+            }
+        }
+
+        WHEN("a channel is edited after it has been used") {
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteDS5, 100, 1 }, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(1, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteF5 }, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteDS5, 100, 1 }, Inlets::NOTE)); // NOLINT
+
+            THEN("the new scale is used") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(note_output[1][1] == NoteF5);
+            }
+        }
+
+        WHEN("an invalid channel is sent") {
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteDS5, 100, 17 }, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteDS5, 100, 0 }, Inlets::NOTE)); // NOLINT
+
+            THEN("nothing is sent") {
+                REQUIRE(note_output.empty());
+            }
+        }
+    }
+}
+
+SCENARIO("quantizing float input with hysteresis") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    GIVEN("a chromatic scale") {
+        auto &note_output = *max::object_getoutput(quantizerTestObject, 0);
+
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerMode(QuantizeMode::ALL_NOTES, Inlets::ARGS));
+
+        for (int i = NoteC5; i <= NoteC6; i++) {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerAddNote(i, Inlets::ARGS));
+        }
+
+        WHEN("the input wobbles around a boundary without hysteresis") {
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.45, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.55, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.45, Inlets::NOTE)); // NOLINT
+
+            THEN("every crossing is sent") {
+                REQUIRE(note_output.size() == 3);
+            }
+        }
+
+        WHEN("the input wobbles around a boundary with hysteresis") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerHysteresis(0.2, Inlets::ARGS)); // NOLINT
+            REQUIRE(quantizerTestObject.getHysteresis() == 0.2);
+
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.45, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.55, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.45, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.65, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.8, Inlets::NOTE));  // NOLINT
+
+            THEN("the output only changes once the band is crossed") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(note_output[0][1] == NoteC5);
+                REQUIRE(note_output[1][1] == NoteC5 + 1);
+            }
+        }
+
+        WHEN("the input sweeps up and down with a band under a degree") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerHysteresis(0.6, Inlets::ARGS)); // NOLINT
+
+            for (double pitch = 60.0; pitch <= 66.0; pitch += 0.25) { // NOLINT
+                REQUIRE_NOTHROW(quantizerTestObject.floatInput(pitch, Inlets::NOTE));
+            }
+
+            for (double pitch = 66.0; pitch >= 61.0; pitch -= 0.25) { // NOLINT
+                REQUIRE_NOTHROW(quantizerTestObject.floatInput(pitch, Inlets::NOTE));
+            }
+
+            THEN("every degree is sent once the band is crossed") {
+                int expected[] = { 60, 61, 62, 63, 64, 65, 64, 63, 62 }; // NOLINT
+
+                REQUIRE(note_output.size() == 9);
+
+                for (size_t i = 0; i < note_output.size(); i++) {
+                    REQUIRE(note_output[i][1] == expected[i]);
+                }
+            }
+        }
+
+        WHEN("the input sweeps with a band wider than a degree") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerHysteresis(1.2, Inlets::ARGS)); // NOLINT
+
+            for (double pitch = 60.0; pitch <= 66.0; pitch += 0.25) { // NOLINT
+                REQUIRE_NOTHROW(quantizerTestObject.floatInput(pitch, Inlets::NOTE));
+            }
+
+            THEN("the output still follows, a degree is skipped while the band is crossed") {
+                REQUIRE(note_output.size() == 4);
+                REQUIRE(note_output[0][1] == 60);
+                REQUIRE(note_output[1][1] == 62);
+                REQUIRE(note_output[2][1] == 64);
+                REQUIRE(note_output[3][1] == 66);
+            }
+        }
+
+        WHEN("the scale changes while a degree is held") {
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.45, Inlets::NOTE)); // NOLINT
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerDeleteNote(NoteC6, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.45, Inlets::NOTE)); // NOLINT
+
+            THEN("the next float is sent again") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(note_output[1][1] == NoteC5);
+            }
+        }
+
+        WHEN("the input is in cents") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerCents(1, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(6400.0, Inlets::NOTE)); // NOLINT
+
+            THEN("it is converted to a note") {
+                REQUIRE(note_output.size() == 1);
+                REQUIRE(note_output[0][1] == NoteE5);
+            }
+        }
+    }
+}
+
+SCENARIO("saving and recalling the quantizer state") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    GIVEN("notes on the quantizer and on channel 2") {
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerAddNote({ NoteC4, NoteE4, NoteG4 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(2, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerAddNote({ NoteC5, NoteD5 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerHysteresis(0.25, Inlets::ARGS)); // NOLINT
+
+        WHEN("the state is stored, changed and recalled") {
+            REQUIRE_NOTHROW(quantizerTestObject.store(3, Inlets::ARGS));
+
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerClear({ "all" }, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(0, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerDeleteNote(NoteE4, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerHysteresis(0.0, Inlets::ARGS));
+            REQUIRE(quantizerTestObject.noteCount() == 2);
+
+            REQUIRE_NOTHROW(quantizerTestObject.recall(3, Inlets::ARGS));
+
+            THEN("every quantizer gets its notes back") {
+                REQUIRE(quantizerTestObject.getEditChannel() == 2);
+                REQUIRE(quantizerTestObject.noteCount() == 2);
+                REQUIRE(quantizerTestObject.getHysteresis() == 0.25);
+
+                REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(0, Inlets::ARGS));
+                REQUIRE(quantizerTestObject.noteCount() == 3);
+            }
+        }
+
+        WHEN("a snapshot is restored into another object") {
+            min::test_wrapper<QuantizerMax> other_instance;
+            QuantizerMax &otherObject = other_instance;
+
+            auto snapshot = quantizerTestObject.snapshot();
+            StateReader reader(snapshot);
+
+            THEN("it has the same settings") {
+                REQUIRE(otherObject.restore(reader));
+                REQUIRE(otherObject.getEditChannel() == 2);
+                REQUIRE(otherObject.noteCount() == 2);
+                REQUIRE(otherObject.getHysteresis() == 0.25);
+            }
+        }
+
+        WHEN("an empty slot or a broken snapshot is recalled") {
+            std::vector<uint8_t> broken = { 'S', 'E' };
+            StateReader reader(broken);
+
+            THEN("nothing changes") {
+                REQUIRE_FALSE(quantizerTestObject.recallSlot(5));
+                REQUIRE_FALSE(quantizerTestObject.recallSlot(16));
+                REQUIRE_FALSE(quantizerTestObject.restore(reader));
+                REQUIRE(quantizerTestObject.noteCount() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("quantizer sheds input over its budget") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+    auto &note_output = *max::object_getoutput(quantizerTestObject, 0);
+
+    REQUIRE_NOTHROW(quantizerTestObject.quantizerMode(QuantizeMode::ALL_NOTES, Inlets::ARGS));
+
+    for (int i = NoteC5; i <= NoteC6; i++) {
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerAddNote(i, Inlets::ARGS));
+    }
+
+    REQUIRE_NOTHROW(quantizerTestObject.budget(1, Inlets::ARGS));
+
+    GIVEN("two note ons in one tick") {
+        REQUIRE_NOTHROW(quantizerTestObject.list({ NoteC5, 100 }, Inlets::NOTE)); // NOLINT
+        REQUIRE_NOTHROW(quantizerTestObject.list({ NoteE5, 100 }, Inlets::NOTE)); // NOLINT
+
+        WHEN("both notes are turned off") {
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteE5, 0 }, Inlets::NOTE));
+            REQUIRE_NOTHROW(quantizerTestObject.list({ NoteC5, 0 }, Inlets::NOTE));
+
+            THEN("the second note and its note off are dropped") {
+                REQUIRE(quantizerTestObject.shedCount() == 1);
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(note_output[0][1] == NoteC5);
+                REQUIRE(note_output[1][1] == NoteC5);
+            }
+        }
+    }
+
+    GIVEN("a burst of float input in one tick") {
+        REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.0, Inlets::NOTE)); // NOLINT
+        REQUIRE_NOTHROW(quantizerTestObject.floatInput(62.0, Inlets::NOTE)); // NOLINT
+        REQUIRE_NOTHROW(quantizerTestObject.floatInput(64.0, Inlets::NOTE)); // NOLINT
+
+        THEN("only the last value is sent on the next tick") {
+            REQUIRE(quantizerTestObject.shedCount() == 2);
+            REQUIRE(note_output.size() == 1);
+
+            quantizerTestObject.flush();
+            REQUIRE(note_output.size() == 2);
+            REQUIRE(note_output[1][1] == NoteE5);
+        }
+    }
+}
+
+SCENARIO("reading Scala scales") { // NOLINT
+    GIVEN("a 12-tone scale") {
+        std::istringstream scl("! major.scl\n!\nMajor\n 7\n!\n 200.0\n 400.0\n 500.0\n 700.0\n 900.0\n 1100.0\n 2/1\n");
+        ScalaLibrary::Scale scale;
+
+        REQUIRE(ScalaLibrary::parseScl(scl, scale));
+        REQUIRE(scale.cents.size() == 7);
+        REQUIRE(scale.cents.back() == Approx(1200.0));
+
+        ScalaLibrary::Tuning tuning = ScalaLibrary::buildTuning(scale);
+
+        THEN("it is not microtonal and has the scale's pitch classes") {
+            REQUIRE(!tuning.isMicrotonal());
+            REQUIRE(tuning.pitchClasses == 0xAB5); // NOLINT
+            REQUIRE(tuning.note[NoteC5] == NoteC5);
+            REQUIRE(tuning.bend[NoteC5] == ScalaLibrary::BEND_CENTER);
+        }
+    }
+
+    GIVEN("a microtonal scale") {
+        std::istringstream scl("Bohlen-Pierce\n 13\n 27/25\n 25/21\n 9/7\n 7/5\n 75/49\n 5/3\n 9/5\n 49/25\n 15/7\n 7/3\n 63/25\n 25/9\n 3/1\n");
+        ScalaLibrary::Scale scale;
+
+        REQUIRE(ScalaLibrary::parseScl(scl, scale));
+
+        ScalaLibrary::Tuning tuning = ScalaLibrary::buildTuning(scale);
+
+        THEN("keys get a note and a pitch bend") {
+            REQUIRE(tuning.isMicrotonal());
+            REQUIRE(tuning.note[NoteC5] == NoteC5);
+            REQUIRE(tuning.bend[NoteC5] == ScalaLibrary::BEND_CENTER);
+            REQUIRE(tuning.bend[NoteC5 + 1] != ScalaLibrary::BEND_CENTER);
+        }
+    }
+
+    GIVEN("a keyboard mapping") {
+        std::istringstream scl("Major\n 7\n 200.0\n 400.0\n 500.0\n 700.0\n 900.0\n 1100.0\n 2/1\n");
+        std::istringstream kbm("! D\n12\n0\n127\n62\n69\n440.0\n12\n");
+        ScalaLibrary::Scale scale;
+
+        REQUIRE(ScalaLibrary::parseScl(scl, scale));
+        REQUIRE(ScalaLibrary::parseKbm(kbm, scale));
+
+        THEN("the scale is transposed to the middle note") {
+            REQUIRE(scale.root == 62);
+            REQUIRE(ScalaLibrary::buildTuning(scale).pitchClasses == 0xAD6); // NOLINT
+        }
+    }
+
+    GIVEN("a broken scale") {
+        std::istringstream scl("Broken\n 3\n 100.0\n");
+        ScalaLibrary::Scale scale;
+
+        THEN("it is rejected") {
+            REQUIRE(!ScalaLibrary::parseScl(scl, scale));
+        }
+    }
+}
+
+namespace {
+    auto writeText(const std::filesystem::path &path, const std::string &text) -> void {
+        std::ofstream(path, std::ios::binary) << text;
+    }
+
+    // Overwrites bytes of a file in place, from the end when at is negative.
+    auto patchFile(const std::filesystem::path &path, std::streamoff at, const std::string &bytes) -> void {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(at, (at < 0) ? std::ios::end : std::ios::beg);
+        file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+} // namespace
+
+SCENARIO("opening a directory of Scala scales") { // NOLINT
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "seidr.ScalaLibrary_test";
+    std::filesystem::path catalogue = directory / ScalaLibrary::CATALOGUE_NAME;
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    writeText(directory / "bp.scl", "Bohlen-Pierce\n 13\n 27/25\n 25/21\n 9/7\n 7/5\n 75/49\n 5/3\n 9/5\n 49/25\n 15/7\n 7/3\n 63/25\n 25/9\n 3/1\n");
+    writeText(directory / "major.scl", "Major\n 7\n 200.0\n 400.0\n 500.0\n 700.0\n 900.0\n 1100.0\n 2/1\n");
+
+    ScalaLibrary library;
+    REQUIRE(library.open(directory.string()));
+
+    THEN("the catalogue is written next to the scales and mapped") {
+        REQUIRE(std::filesystem::exists(catalogue));
+        REQUIRE(library.size() == 2);
+        REQUIRE(library.bytes() == 0);
+    }
+
+    THEN("scales are found by their whole name") {
+        REQUIRE(library.find("major") != nullptr);
+        REQUIRE(library.find("major")->pitchClasses == 0xAB5); // NOLINT
+        REQUIRE(library.find("bp")->isMicrotonal());
+        REQUIRE(library.find("majo") == nullptr);
+        REQUIRE(library.find("minor") == nullptr);
+    }
+
+    WHEN("the directory is opened again without changes") {
+        // The names are stored last, a rebuilt catalogue wouldn't have the
+        // last letter of "major" changed.
+        library.close();
+        patchFile(catalogue, -1, "x");
+        REQUIRE(library.open(directory.string()));
+
+        THEN("the catalogue is mapped as it is") {
+            REQUIRE(library.size() == 2);
+            REQUIRE(library.find("major") == nullptr);
+        }
+    }
+
+    WHEN("a scale is added") {
+        writeText(directory / "minor.scl", "Minor\n 7\n 200.0\n 300.0\n 500.0\n 700.0\n 800.0\n 1000.0\n 2/1\n");
+        REQUIRE(library.open(directory.string()));
+
+        THEN("the stamp is stale and the catalogue is rebuilt") {
+            REQUIRE(library.size() == 3);
+            REQUIRE(library.find("minor") != nullptr);
+            REQUIRE(library.find("major") != nullptr);
+        }
+    }
+
+    WHEN("the count in the catalogue is damaged") {
+        // The count follows the 8 byte magic and the 4 byte version.
+        library.close();
+        patchFile(catalogue, 12, std::string(4, '\xFF')); // NOLINT
+        REQUIRE(library.open(directory.string()));
+
+        THEN("it is not trusted and the catalogue is rebuilt") {
+            REQUIRE(library.size() == 2);
+            REQUIRE(library.find("major") != nullptr);
+        }
+    }
+
+    WHEN("a name in the catalogue points past its end") {
+        // The first entry's name offset follows its 8 byte hash.
+        library.close();
+        patchFile(catalogue, 40 + 8, std::string(4, '\x7F')); // NOLINT
+        REQUIRE(library.open(directory.string()));
+
+        THEN("it is not trusted and the catalogue is rebuilt") {
+            REQUIRE(library.size() == 2);
+            REQUIRE(library.find("bp") != nullptr);
+            REQUIRE(library.find("major") != nullptr);
+        }
+    }
+
+    library.close();
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+SCENARIO("opening Scala scales while a microtonal scale plays") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "seidr.ScalaLibrary_reopen_test";
+    std::filesystem::create_directories(directory);
+    writeText(directory / "bp.scl", "Bohlen-Pierce\n 13\n 27/25\n 25/21\n 9/7\n 7/5\n 75/49\n 5/3\n 9/5\n 49/25\n 15/7\n 7/3\n 63/25\n 25/9\n 3/1\n");
+
+    REQUIRE(quantizerTestObject.openScales(directory.string()));
+    REQUIRE(quantizerTestObject.selectScale("bp"));
+    REQUIRE(quantizerTestObject.isMicrotonal());
+
+    WHEN("the scales are opened again") {
+        REQUIRE(quantizerTestObject.openScales(directory.string()));
+
+        THEN("the tuning from the old catalogue is let go of") {
+            REQUIRE_FALSE(quantizerTestObject.isMicrotonal());
+            REQUIRE(quantizerTestObject.selectScale("bp"));
+            REQUIRE(quantizerTestObject.isMicrotonal());
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+}
+
+SCENARIO("quantizing a raw MIDI byte stream") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    GIVEN("a scale on channel 1 and raw mode") {
+        auto &note_output = *max::object_getoutput(quantizerTestObject, 0);
+
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(1, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerMode(QuantizeMode::ALL_NOTES, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteC5, NoteE5 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerRaw(1, Inlets::ARGS));
+        REQUIRE(quantizerTestObject.isRaw());
+
+        WHEN("a note on and a note off are sent with running status") {
+            for (int byte : { 0x90, int(NoteDS5), 100, 0xF8, int(NoteDS5), 0 }) { // NOLINT
+                REQUIRE_NOTHROW(quantizerTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            THEN("both notes are quantized and sent as bytes") {
+                REQUIRE(note_output.size() == 7);
+                REQUIRE(note_output[0][1] == 0x90);
+                REQUIRE(note_output[1][1] == NoteE5);
+                REQUIRE(note_output[2][1] == 100);
+                REQUIRE(note_output[3][1] == 0xF8);
+                REQUIRE(note_output[4][1] == 0x90);
+                REQUIRE(note_output[5][1] == NoteE5);
+                REQUIRE(note_output[6][1] == 0);
+            }
+        }
+
+        WHEN("a note is sent on a channel without notes of its own") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerChannel(0, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteC5, NoteG5 }, Inlets::ARGS));
+
+            for (int byte : { 0x91, int(NoteDS5), 100 }) { // NOLINT
+                REQUIRE_NOTHROW(quantizerTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            THEN("it is quantized with the scale for notes without a channel") {
+                REQUIRE(note_output.size() == 3);
+                REQUIRE(note_output[0][1] == 0x91);
+                REQUIRE(note_output[1][1] == NoteG5);
+                REQUIRE(note_output[2][1] == 100);
+            }
+        }
+
+        WHEN("a control change is sent") {
+            for (int byte : { 0xB0, 7, 64 }) { // NOLINT
+                REQUIRE_NOTHROW(quantizerTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            THEN("it is passed through") {
+                REQUIRE(note_output.size() == 3);
+                REQUIRE(note_output[0][1] == 0xB0);
+                REQUIRE(note_output[1][1] == 7);
+                REQUIRE(note_output[2][1] == 64);
+            }
+        }
+
+        WHEN("raw mode is off") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerRaw(0, Inlets::ARGS));
+            REQUIRE_NOTHROW(quantizerTestObject.integerInput(0x90, Inlets::NOTE)); // NOLINT
+
+            THEN("bytes are ignored") {
+                REQUIRE(note_output.empty());
+            }
+        }
+    }
+}
+
+namespace {
+    // Frames of a buffer~, with the part of the buffer_lock interface the
+    // scale reads.
+    struct FakeBuffer {
+        std::vector<float> frames;
+
+        auto frame_count() const -> size_t { return this->frames.size(); }
+        auto lookup(size_t frame) -> float & { return this->frames[frame]; }
+    };
+
+    // A buffer_lock on a mocked buffer~, what it holds is set by the test.
+    struct FakeBufferLock {
+        inline static bool exists = false;
+        inline static FakeBuffer buffer;
+
+        explicit FakeBufferLock(min::buffer_reference &) {}
+
+        auto valid() const -> bool { return exists; }
+        auto frame_count() const -> size_t { return buffer.frame_count(); }
+        auto lookup(size_t frame) -> float & { return buffer.lookup(frame); }
+    };
+} // namespace
+
+SCENARIO("reading a scale from a buffer~") { // NOLINT
+    BufferScale scale;
+    QuantizerSettings settings;
+
+    GIVEN("12 frames with a C major scale") {
+        FakeBuffer buffer {{ 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1 }};
+
+        THEN("every octave gets the pitch classes above 0") {
+            REQUIRE(BufferScale::read(buffer, settings));
+            REQUIRE(settings.hasNote(NoteC4));
+            REQUIRE(settings.hasNote(NoteB3));
+            REQUIRE_FALSE(settings.hasNote(NoteC4 + 1));
+            REQUIRE(settings.hasNote(MIDI::RANGE_HIGH));
+        }
+    }
+
+    GIVEN("128 frames") {
+        FakeBuffer buffer {std::vector<float>(BufferScale::NOTES, 0.0F)};
+        buffer.frames[NoteC4] = 1.0F;
+        buffer.frames[NoteE4] = 0.5F; // NOLINT
+
+        THEN("each frame is one note") {
+            REQUIRE(BufferScale::read(buffer, settings));
+            REQUIRE(settings.hasNote(NoteC4));
+            REQUIRE(settings.hasNote(NoteE4));
+            REQUIRE_FALSE(settings.hasNote(NoteC5));
+        }
+    }
+
+    GIVEN("fewer than 12 frames") {
+        FakeBuffer buffer {{ 1, 1, 1 }};
+        settings.addNote(NoteC4);
+
+        THEN("the scale is not read and the notes are kept") {
+            REQUIRE_FALSE(BufferScale::read(buffer, settings));
+            REQUIRE(settings.hasNote(NoteC4));
+        }
+    }
+
+    GIVEN("a number of frames other than 12 or 128") {
+        FakeBuffer between {std::vector<float>(13, 1.0F)};  // NOLINT
+        FakeBuffer longer {std::vector<float>(129, 1.0F)};  // NOLINT
+        settings.addNote(NoteC4);
+
+        THEN("the scale is not read and the notes are kept") {
+            REQUIRE_FALSE(BufferScale::read(between, settings));
+            REQUIRE_FALSE(BufferScale::read(longer, settings));
+            REQUIRE(settings.hasNote(NoteC4));
+            REQUIRE_FALSE(settings.hasNote(NoteC4 + 1));
+        }
+    }
+
+    GIVEN("a bound buffer") {
+        REQUIRE_FALSE(scale.isChanged());
+        scale.bind(2);
+
+        THEN("it is read once after every change and not in between") {
+            REQUIRE(scale.slot() == 2);
+            REQUIRE(scale.isChanged());
+            scale.markRead(scale.changes());
+            REQUIRE_FALSE(scale.isChanged());
+
+            scale.touch();
+            scale.touch();
+            REQUIRE(scale.isChanged());
+            scale.markRead(scale.changes());
+            REQUIRE_FALSE(scale.isChanged());
+        }
+
+        THEN("a read that isn't marked is tried again") {
+            uint32_t changes = scale.changes();
+            REQUIRE(scale.isChanged());
+            REQUIRE(scale.isChanged());
+
+            scale.touch();
+            scale.markRead(changes);
+            REQUIRE(scale.isChanged());
+        }
+
+        THEN("an unbound buffer is never read") {
+            scale.unbind();
+            scale.touch();
+            REQUIRE_FALSE(scale.isChanged());
+        }
+    }
+}
+
+SCENARIO("binding the quantizer to a buffer~") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    GIVEN("a scale and a buffer~ that doesn't exist") {
+        REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteC4, NoteG4 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerBuffer({ "no.such.buffer" }, Inlets::ARGS));
+
+        THEN("the quantizer is bound and keeps its scale until the buffer~ is there") {
+            REQUIRE(quantizerTestObject.isBufferBound());
+            REQUIRE_NOTHROW(quantizerTestObject.receiveNote(NoteC4, 100)); // NOLINT
+            REQUIRE(quantizerTestObject.noteCount() == 2);
+        }
+
+        THEN("no argument stops reading the buffer~") {
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerBuffer(min::atoms {}, Inlets::ARGS));
+            REQUIRE_FALSE(quantizerTestObject.isBufferBound());
+        }
+    }
+
+    GIVEN("a bound buffer~ read through its buffer_lock") {
+        auto &note_output = *max::object_getoutput(quantizerTestObject, 0);
+
+        FakeBufferLock::exists = false;
+        FakeBufferLock::buffer = FakeBuffer {{ 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1 }};
+        REQUIRE_NOTHROW(quantizerTestObject.updateNotes({ NoteC4, NoteG4 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(quantizerTestObject.quantizerBuffer({ "scale.buffer" }, Inlets::ARGS));
+
+        WHEN("the buffer~ is created after the read") {
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+            REQUIRE(quantizerTestObject.noteCount() == 2);
+
+            FakeBufferLock::exists = true;
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+
+            THEN("the failed read is tried again and the scale is read") {
+                REQUIRE(quantizerTestObject.noteCount() == 7 * 10 + 5); // NOLINT
+            }
+        }
+
+        WHEN("the buffer~ has the wrong number of frames") {
+            FakeBufferLock::exists = true;
+            FakeBufferLock::buffer = FakeBuffer {std::vector<float>(64, 1.0F)}; // NOLINT
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+            REQUIRE(quantizerTestObject.noteCount() == 2);
+
+            FakeBufferLock::buffer = FakeBuffer {{ 1, 0, 1, 0, 1, 1, 0, 1, 0, 1, 0, 1 }};
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+
+            THEN("the scale is kept until a read goes through") {
+                REQUIRE(quantizerTestObject.noteCount() == 7 * 10 + 5); // NOLINT
+            }
+        }
+
+        WHEN("the scale has been read") {
+            FakeBufferLock::exists = true;
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+
+            FakeBufferLock::buffer.frames.assign(BufferScale::PITCH_CLASSES, 1.0F);
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+
+            THEN("it isn't read again until the buffer~ changes") {
+                REQUIRE(quantizerTestObject.noteCount() == 7 * 10 + 5); // NOLINT
+            }
+        }
+
+        WHEN("a float is held when the scale is read") {
+            FakeBufferLock::exists = true;
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.0, Inlets::NOTE)); // NOLINT
+
+            REQUIRE_NOTHROW(quantizerTestObject.quantizerBuffer({ "scale.buffer" }, Inlets::ARGS));
+            quantizerTestObject.syncBuffer<FakeBufferLock>();
+            REQUIRE_NOTHROW(quantizerTestObject.floatInput(60.0, Inlets::NOTE)); // NOLINT
+
+            THEN("the next float is sent with the new scale") {
+                REQUIRE(note_output.size() == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("quantizer under concurrent messages", "[.stress]") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<QuantizerMax> an_instance;
+    QuantizerMax &quantizerTestObject = an_instance;
+
+    auto &note_output = *max::object_getoutput(quantizerTestObject, 0);
+    auto &velocity_output = *max::object_getoutput(quantizerTestObject, 1);
+
+    // Every note in is one quantized note out.
+    uint64_t notes = 0;
+    uint64_t invalid = 0;
+
+    auto drain = [&] {
+        for (const auto &entry : note_output) {
+            int note = static_cast<int>(entry.back());
+            invalid += ((note >= MIDI::RANGE_LOW) && (note <= MIDI::RANGE_HIGH)) ? 0 : 1;
+        }
+
+        notes += note_output.size();
+        note_output.clear();
+        velocity_output.clear();
+    };
+
+    StressRunner stress(100000); // NOLINT
+
+    stress.scheduler("list", [&](uint64_t n) {
+        quantizerTestObject.list({ static_cast<int>(n % 128), 100 }, Inlets::NOTE); // NOLINT
+    }, drain);
+
+    stress.main("update", [&](uint64_t n) {
+        int root = static_cast<int>(n % 12); // NOLINT
+        quantizerTestObject.updateNotes({ NoteC4 + root, NoteE4 + root, NoteG4 + root }, Inlets::ARGS);
+    });
+
+    stress.main("range", [&](uint64_t n) {
+        int low = static_cast<int>(n % 64); // NOLINT
+        quantizerTestObject.quantizerRange({ low, low + 64 }, Inlets::ARGS); // NOLINT
+    });
+
+    StressRunner::report("seidr.Quantizer", stress.run(), std::cout);
+
+    THEN("every note was quantized into the MIDI range and the state can be read") {
+        REQUIRE(notes == 100000); // NOLINT
+        REQUIRE(invalid == 0);
+
+        std::vector<uint8_t> state = quantizerTestObject.snapshot();
+        StateReader reader(state);
+
+        REQUIRE(reader.isValid());
+        REQUIRE(quantizerTestObject.restore(reader));
+    }
+}
@@ -3,7 +3,6 @@
 #include <algorithm>
 
 using namespace c74;
-using NoteReturnCodes = MIDI::NoteReturnCodes;
 
 RandomOctaveMax::RandomOctaveMax(const min::atoms &args) {
     // Default range
@@ -19,37 +18,276 @@ RandomOctaveMax::RandomOctaveMax(const min::atoms &args) {
         }
     }
     
-    this->randomOctave_.setRange(low, high);
+    this->setRange(low, high);
+
+    // State saved with the patcher.
+    StateSnapshot::load(this->state(), this->slots_, [this](StateReader &reader) { return this->restore(reader); });
+}
+
+auto RandomOctaveMax::snapshot() -> std::vector<uint8_t> {
+    StateWriter writer(STATE_VERSION);
+    writer.write(static_cast<int8_t>(this->octaves_.low()));
+    writer.write(static_cast<int8_t>(this->octaves_.high()));
+    // Weights past the last octave are never used.
+    const auto &weights = this->octaves_.weights();
+    writer.writeArray(weights.data(), std::min<size_t>(weights.size(), OctaveDistribution::OCTAVE_COUNT));
+    writer.write(static_cast<uint16_t>(this->notes_.getPolyphony()));
+    writer.write(this->duration_);
+    writer.write(this->raw_);
+    return std::move(writer.bytes());
+}
+
+auto RandomOctaveMax::restore(StateReader &reader) -> bool {
+    int8_t low = 0;
+    int8_t high = 0;
+    std::vector<double> weights;
+    uint16_t polyphony = 0;
+    uint16_t duration = 0;
+    bool raw = false;
+
+    if ((reader.version() != STATE_VERSION) || !reader.read(low) || !reader.read(high) ||
+        !reader.readArray(weights, OctaveDistribution::OCTAVE_COUNT) || !reader.read(polyphony) ||
+        !reader.read(duration) || !reader.read(raw)) {
+        return false;
+    }
+
+    this->setRange(low, high);
+
+    if (weights.empty()) {
+        this->octaves_.clearWeights();
+    } else {
+        this->octaves_.setWeights(weights);
+    }
+
+    this->setPolyphony(polyphony);
+    this->setDuration(duration);
+    this->setRaw(raw);
+    return true;
+}
+
+auto RandomOctaveMax::recallSlot(int slot) -> bool {
+    return this->slots_.recall(slot, [this](StateReader &reader) { return this->restore(reader); });
+}
+
+auto RandomOctaveMax::setRange(int low, int high) -> void {
+    this->octaves_.setRange(low, high);
+}
+
+auto RandomOctaveMax::setWeights(const min::atoms &weights) -> void {
+    if (weights.empty()) {
+        this->octaves_.clearWeights();
+        return;
+    }
+
+    std::vector<double> values;
+    values.reserve(weights.size());
+
+    for (const auto &weight : weights) {
+        values.push_back(static_cast<double>(weight));
+    }
+
+    this->octaves_.setWeights(values);
+}
+
+auto RandomOctaveMax::memoryUsage() const -> size_t {
+    return sizeof(*this) + (this->octaves_.weights().capacity() * sizeof(double)) + this->slots_.bytes() + this->recorder_.bytes();
+}
+
+auto RandomOctaveMax::setPolyphony(int polyphony) -> void {
+    this->notes_.setPolyphony(polyphony);
+
+    // Turn off the oldest notes above the new limit.
+    NoteIndex::Note stolen {};
+
+    while ((this->notes_.size() > this->notes_.getPolyphony()) && this->notes_.steal(stolen)) {
+        this->cancelNoteOff(stolen.voice);
+        this->sendNote(stolen.pitch, 0, stolen.channel);
+    }
+}
+
+auto RandomOctaveMax::setDuration(int duration) -> void {
+    this->duration_ = static_cast<uint16_t>(std::clamp(duration, 0, static_cast<int>(TimerWheel<NoteIndex::VOICES>::SPAN - 1)));
+}
+
+// Max logical time, the note offs stay in time with the scheduler.
+auto RandomOctaveMax::now() -> uint32_t {
+    return static_cast<uint32_t>(c74::max::gettime());
+}
+
+auto RandomOctaveMax::scheduleNoteOffs() -> void {
+    if (this->noteOffs_.empty()) {
+        this->noteOffTimer.stop();
+    } else {
+        this->noteOffTimer.delay(this->noteOffs_.nextDue());
+    }
+}
+
+auto RandomOctaveMax::cancelNoteOff(int voice) -> void {
+    if (voice >= 0) {
+        this->noteOffs_.cancel(voice);
+    }
+}
+
+auto RandomOctaveMax::expireNotes(uint32_t now) -> void {
+    this->noteOffs_.advance(now, [this](int voice) {
+        NoteIndex::Note note {};
+
+        if (this->notes_.remove(voice, note)) {
+            this->sendNote(note.pitch, 0, note.channel);
+        }
+    });
+}
+
+auto RandomOctaveMax::getQueuedNotes() const -> std::vector<NoteIndex::Note> {
+    return {this->queue_.begin(), this->queue_.begin() + this->queueSize_};
+}
+
+auto RandomOctaveMax::queueNote(int pitch, int velocity, int channel) -> void {
+    this->queue_[this->queueSize_++] = {0, static_cast<uint8_t>(pitch), static_cast<uint8_t>(velocity), -1, static_cast<uint8_t>(channel)};
+}
+
+// Release the voices of an input note on a channel, or on every channel
+// with NoteIndex::ANY_CHANNEL. Each note off goes out on the channel its
+// voice was played on.
+auto RandomOctaveMax::queueRelease(int note, int channel) -> void {
+    NoteIndex::Entry released = this->notes_.release(note, channel);
+
+    // Notes that were never played are passed through, the note off of a
+    // stolen note was sent when it was stolen.
+    if ((released.count == 0) && !released.stolen) {
+        this->queueNote(note, 0, (channel == NoteIndex::ANY_CHANNEL) ? 0 : channel);
+    }
+
+    for (int slot = 0; slot < released.count; slot++) {
+        this->cancelNoteOff(released.voice[slot]);
+        this->queueNote(released.pitch[slot], 0, released.channel[slot]);
+    }
+}
+
+auto RandomOctaveMax::sendQueue() -> void {
+    for (int i = 0; i < this->queueSize_; i++) {
+        // Send to outputs.
+        this->sendNote(this->queue_[i].pitch, this->queue_[i].velocity, this->queue_[i].channel);
+    }
+
+    this->queueSize_ = 0;
+}
+
+auto RandomOctaveMax::sendNote(int pitch, int velocity, int channel) -> void {
+    if (this->raw_) {
+        output_note.send(MidiParser::NOTE_ON | channel);
+        output_note.send(pitch);
+        output_note.send(velocity);
+    } else {
+        output_note.send({ pitch, velocity });
+    }
+}
+
+auto RandomOctaveMax::sendRaw(const MidiParser::Message &message) -> void {
+    output_note.send(message.status);
+
+    if (message.size > 1) {
+        output_note.send(message.data1);
+    }
+
+    if (message.size > 2) {
+        output_note.send(message.data2);
+    }
+}
+
+auto RandomOctaveMax::setRaw(bool raw) -> void {
+    this->raw_ = raw;
+    this->parser_.reset();
+}
+
+auto RandomOctaveMax::processRawByte(int byte) -> void {
+    MidiParser::Message message {};
+
+    if (!this->parser_.parse(byte, message)) {
+        return;
+    }
+
+    // Everything but notes is passed through.
+    if (!message.isNote()) {
+        this->sendRaw(message);
+        return;
+    }
+
+    this->processNoteMessage(message.data1, message.velocity(), message.channel());
 }
 
 auto RandomOctaveMax::clearNoteMessage(int note) -> void {
     // Clear a single note.
-    randomOctave_.note(note, 0);
-    output_note.send({note, 0});
-    randomOctave_.clearQueue();
+    if ((note < MIDI::RANGE_LOW) || (note > MIDI::RANGE_HIGH)) {
+        return;
+    }
+
+    this->queueRelease(note, NoteIndex::ANY_CHANNEL);
+    this->sendQueue();
 }
 
 auto RandomOctaveMax::clearAllNotesMessage() -> void {
+    // Turn off the voices on their own channels first.
+    NoteIndex::Note stolen {};
+
+    while (this->notes_.steal(stolen)) {
+        this->sendNote(stolen.pitch, 0, stolen.channel);
+    }
+
     // Send all notes off as fallback.
-    this->randomOctave_.removeAll();
+    this->notes_.clear();
+    this->noteOffs_.clear();
 
     for (int note = 0; note < MIDI::KEYBOARD_SIZE; note++) {
-        output_note.send({note, 0});
+        this->sendNote(note, 0, 0);
     }
-
-    randomOctave_.clearQueue();
 }
 
-auto RandomOctaveMax::processNoteMessage(int note, int velocity) -> void { // NOLINT
-    // The input needs to be an array with two integes.
-    if (this->randomOctave_.note(note, velocity) == NoteReturnCodes::OK) { 
-        for (const auto &currentNote : randomOctave_.getNoteQueue()) {
-            // Send to outputs.
-            output_note.send({ currentNote->pitch(), currentNote->velocity() });
+auto RandomOctaveMax::processNoteMessage(int note, int velocity, int channel) -> void { // NOLINT
+    // Validate input.
+    if ((note < MIDI::RANGE_LOW) || (note > MIDI::RANGE_HIGH) || (velocity < 0) || (velocity > MIDI::RANGE_HIGH)) {
+        return;
+    }
+
+    // Send the note offs that are due first.
+    if (this->duration_ > 0) {
+        this->expireNotes(RandomOctaveMax::now());
+    }
+
+    if (velocity == 0) {
+        this->queueRelease(note, channel);
+    } else {
+        bool weighted = false;
+        int pitch = this->octaves_.pick(note % MIDI::OCTAVE, weighted);
+
+        // The pitch class has no octave in the range. Without weights the
+        // note is played as it is, with weights none of its octaves has a
+        // weight and the note is not played.
+        if (pitch < 0) {
+            if (weighted) {
+                this->sendQueue();
+                return;
+            }
+
+            pitch = note;
         }
 
-        randomOctave_.clearQueue();
+        NoteIndex::Note evicted {};
+
+        if (this->notes_.add(note, pitch, velocity, evicted, channel)) {
+            this->cancelNoteOff(evicted.voice);
+            this->queueNote(evicted.pitch, 0, evicted.channel);
+        }
+
+        if (this->duration_ > 0) {
+            this->noteOffs_.schedule(this->notes_.newest(), this->duration_);
+            this->scheduleNoteOffs();
+        }
+
+        this->queueNote(pitch, velocity, channel);
     }
+
+    this->sendQueue();
 }
 
 MIN_EXTERNAL(RandomOctaveMax); // NOLINT
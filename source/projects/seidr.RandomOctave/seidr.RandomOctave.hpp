@@ -6,7 +6,14 @@
 
 #pragma once
 
-#include "RandomOctave/RandomOctave.hpp"
+#include "MessageArgs.hpp"
+#include "MessageRecorder.hpp"
+#include "MidiParser.hpp"
+#include "NoteIndex.hpp"
+#include "OctaveDistribution.hpp"
+#include "StateSnapshot.hpp"
+#include "TimerWheel.hpp"
+#include <array>
 #include <string>
 #include <c74_min.h>
 
@@ -14,7 +21,31 @@ using namespace c74;
 
 class RandomOctaveMax : public min::object<RandomOctaveMax> {
 private:
-    RandomOctave randomOctave_;
+    OctaveDistribution octaves_;
+    NoteIndex notes_;
+
+    // Scheduled note offs in duration mode, one timer for each voice.
+    TimerWheel<NoteIndex::VOICES> noteOffs_;
+    uint16_t duration_ = 0;
+
+    // Notes waiting to be sent for the current message.
+    std::array<NoteIndex::Note, 2 * NoteIndex::SLOTS> queue_ = {};
+    uint8_t queueSize_ = 0;
+
+    // Raw mode, MIDI bytes in and out.
+    MidiParser parser_;
+    bool raw_ = false;
+
+    MessageRecorder recorder_;
+
+    StateSlots<> slots_;
+
+    auto queueNote(int pitch, int velocity, int channel) -> void;
+    auto queueRelease(int note, int channel) -> void;
+    auto sendQueue() -> void;
+    auto sendNote(int pitch, int velocity, int channel) -> void;
+    auto sendRaw(const MidiParser::Message &message) -> void;
+    auto cancelNoteOff(int voice) -> void;
 
 public:
     MIN_DESCRIPTION{"Randomize the octave of a MIDI note message."}; // NOLINT 
@@ -27,28 +58,44 @@ public:
         ARGS = 1
     };
 
+    enum : uint16_t {
+        STATE_VERSION = 1
+    };
+
     explicit RandomOctaveMax(const min::atoms &args = {});
 
-    auto processNoteMessage(int note, int velocity) -> void;
+    auto processNoteMessage(int note, int velocity, int channel = 0) -> void;
     auto clearAllNotesMessage() -> void;
     auto clearNoteMessage(int note) -> void;
+    auto setRange(int low, int high) -> void;
+    auto setWeights(const min::atoms &weights) -> void;
+    auto isWeighted() const -> bool { return this->octaves_.isWeighted(); }
+    auto setPolyphony(int polyphony) -> void;
+    auto getPolyphony() const -> int { return this->notes_.getPolyphony(); }
 
-    auto getActiveNotes() -> std::vector<std::shared_ptr<ActiveNote>> { return this->randomOctave_.getActiveNotes(); }
-    auto getQueuedNotes() -> std::vector<std::shared_ptr<ActiveNote>> { return this->randomOctave_.getNoteQueue(); }
-    
-    static auto isNoteNumber(const std::string& str, int& result) -> bool {
-        try {
-            size_t pos;
-            result = std::stoi(str, &pos);
-            return pos == str.length();
-        } catch (...) {
-            return false;
-        }
-    }
+    auto setDuration(int duration) -> void;
+    auto getDuration() const -> int { return this->duration_; }
+    auto expireNotes(uint32_t now) -> void;
+    auto scheduleNoteOffs() -> void;
+    static auto now() -> uint32_t;
+
+    auto getActiveNotes() const -> std::vector<NoteIndex::Note> { return this->notes_.notes(); }
+    auto getQueuedNotes() const -> std::vector<NoteIndex::Note>;
+
+    auto setRaw(bool raw) -> void;
+    auto isRaw() const -> bool { return this->raw_; }
+    auto processRawByte(int byte) -> void;
+
+    auto memoryUsage() const -> size_t;
+
+    // State snapshots.
+    auto snapshot() -> std::vector<uint8_t>;
+    auto restore(StateReader &reader) -> bool;
+    auto recallSlot(int slot) -> bool;
 
     // Inlets
     min::inlet<> input_note_velcoty {this, "(list) note, velocity"};
-    min::inlet<> input_arguments    {this, "(range|clear) arguments"};
+    min::inlet<> input_arguments    {this, "(range|clear|weights|polyphony|duration|raw|store|recall) arguments"};
 
     // Outlets
     min::outlet<> output_note       {this, "(anything) pitch"};
@@ -56,13 +103,20 @@ public:
     min::message<min::threadsafe::yes> anything {
         this, "anything", "Handle any input",
         MIN_FUNCTION {
+            this->recorder_.record(inlet, "anything", args);
+
             return {};
         }
     };
     
     min::message<min::threadsafe::yes> integerInput {
-        this, "int", "Handle integer input",
+        this, "int", "MIDI byte in raw mode",
         MIN_FUNCTION {
+            this->recorder_.record(inlet, "int", args);
+
+            if (Inlets(inlet) == Inlets::NOTE && this->raw_ && !args.empty()) {
+                this->processRawByte(static_cast<int> (args[0]));
+            }
             return {};
         }
     };
@@ -70,6 +124,8 @@ public:
     min::message<min::threadsafe::yes> floatInput {
         this, "float", "Handle integer input",
         MIN_FUNCTION {
+            this->recorder_.record(inlet, "float", args);
+
             return {};
         }
     };
@@ -77,6 +133,8 @@ public:
     min::message<min::threadsafe::yes> bangInput {
         this, "bang", "Handle bang input",
         MIN_FUNCTION {
+            this->recorder_.record(inlet, "bang", args);
+
             return {};
         }
     };
@@ -84,6 +142,8 @@ public:
     min::message<min::threadsafe::yes> list {
         this, "list", "Process note messages",
         MIN_FUNCTION {
+            this->recorder_.record(inlet, "list", args);
+
             if (Inlets(inlet) == Inlets::NOTE && args.size() >= 2) {
                 int note = static_cast<int> (args[0]);
                 int velocity = static_cast<int> (args[1]);
@@ -96,18 +156,17 @@ public:
     min::message<min::threadsafe::yes> clear {
         this, "clear", "Clear specific note",
         MIN_FUNCTION {
+            this->recorder_.record(inlet, "clear", args);
+
             if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
-                const std::string& arg = args[0];
-                
-                if (arg == "all") {
+                int note = 0;
+
+                if (MessageArgs::isSymbol(args[0], MessageArgs::ALL)) {
                     this->clearAllNotesMessage();
+                } else if (MessageArgs::readNote(args[0], note)) {
+                    this->clearNoteMessage(note);
                 } else {
-                    int note;
-                    if (RandomOctaveMax::isNoteNumber(arg, note)) {
-                        this->clearNoteMessage(note);
-                    } else {
-                        std::cerr << "Error: Invalid argument. Use 'all' or a note number.\n";
-                    }
+                    max::object_error((max::t_object*) this, "clear needs all, a note number or a note name");
                 }
             }
             return {};
@@ -117,12 +176,163 @@ public:
     min::message<min::threadsafe::yes> range {
         this, "range", "Set range",
         MIN_FUNCTION {
-            if (Inlets(inlet) == Inlets::ARGS && !args.empty() && args.size() >= 2) {
-                int low = static_cast<int> (args[0]);
-                int high = static_cast<int> (args[1]);
-                this->randomOctave_.setRange(low, high);
+            this->recorder_.record(inlet, "range", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int low = 0;
+                int high = 0;
+
+                if (!MessageArgs::readInts(args, low, high)) {
+                    max::object_error((max::t_object*) this, "range needs a low and a high note");
+                    return {};
+                }
+
+                this->setRange(low, high);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> weights {
+        this, "weights", "Set the weight of each octave in the range, no arguments for an even spread",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "weights", args);
+
+            if (Inlets(inlet) == Inlets::ARGS) {
+                this->setWeights(args);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> polyphony {
+        this, "polyphony", "Set the number of notes that can play at once, the oldest note is stolen when it is reached",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "polyphony", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int voices = 0;
+
+                if (!MessageArgs::readInt(args[0], voices)) {
+                    max::object_error((max::t_object*) this, "polyphony needs a number of notes");
+                    return {};
+                }
+
+                this->setPolyphony(voices);
             }
             return {};
         }
     };
+
+    min::message<min::threadsafe::yes> duration {
+        this, "duration", "Turn every note off after this many milliseconds, 0 waits for note offs",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "duration", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int milliseconds = 0;
+
+                if (!MessageArgs::readInt(args[0], milliseconds)) {
+                    max::object_error((max::t_object*) this, "duration needs a number of milliseconds");
+                    return {};
+                }
+
+                this->setDuration(milliseconds);
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> raw {
+        this, "raw", "Read and send raw MIDI bytes instead of note velocity lists",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "raw", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                this->setRaw(static_cast<int> (args[0]) != 0);
+            }
+            return {};
+        }
+    };
+
+    min::message<> store {
+        this, "store", "Store the state in a slot (0-15)",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "store", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    max::object_error((max::t_object*) this, "store needs a slot number");
+                    return {};
+                }
+
+                this->slots_.store(slot, this->snapshot());
+            }
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> recall {
+        this, "recall", "Recall the state stored in a slot (0-15)",
+        MIN_FUNCTION {
+            this->recorder_.record(inlet, "recall", args);
+
+            if (Inlets(inlet) == Inlets::ARGS && !args.empty()) {
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    max::object_error((max::t_object*) this, "recall needs a slot number");
+                    return {};
+                }
+
+                this->recallSlot(slot);
+            }
+            return {};
+        }
+    };
+
+    min::message<> savestate {
+        this, "savestate", "Save the state and the slots with the patcher",
+        MIN_FUNCTION {
+            min::dict state {args[0]};
+            StateSnapshot::save(state, this->snapshot(), this->slots_);
+            return {};
+        }
+    };
+
+    min::message<min::threadsafe::yes> memory {
+        this, "memory", "Post the number of bytes used by this instance",
+        MIN_FUNCTION {
+            max::object_post((max::t_object*) this, "%zu bytes", this->memoryUsage());
+            return {};
+        }
+    };
+
+    min::message<> record {
+        this, "record", "Record every message to a file, no argument stops recording",
+        MIN_FUNCTION {
+            if (Inlets(inlet) == Inlets::ARGS) {
+                if (args.empty()) {
+                    this->recorder_.close();
+                } else {
+                    std::string path = args[0];
+
+                    if (!this->recorder_.open(path)) {
+                        max::object_error((max::t_object*) this, "could not record to %s", path.c_str());
+                    }
+                }
+            }
+            return {};
+        }
+    };
+
+    min::timer<> noteOffTimer {
+        this, MIN_FUNCTION {
+            this->expireNotes(RandomOctaveMax::now());
+            this->scheduleNoteOffs();
+            return {};
+        }
+    };
 };
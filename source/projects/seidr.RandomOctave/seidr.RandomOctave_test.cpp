@@ -8,6 +8,10 @@
 #include "seidr.RandomOctave.cpp" // NOLINT
 #include "seidr.RandomOctave.hpp"
 #include <c74_min_unittest.h>
+#include "StressRunner.hpp"
+#include <iostream>
+#include <filesystem>
+#include <random>
 
 using namespace c74;
 using namespace MIDI;
@@ -411,6 +415,28 @@ SCENARIO("seidr.RandomOctaveMax test clear note functions") { // NOLINT
         REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
         REQUIRE(randomOctaveTestObject.getQueuedNotes().empty());
     }
+
+    GIVEN("clear a note by name") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ 62, 100 }, Inlets::NOTE)); // NOLINT
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ 70, 100 }, Inlets::NOTE)); // NOLINT
+        REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 2);
+        REQUIRE_NOTHROW(randomOctaveTestObject.clear("D4", Inlets::ARGS));
+        REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 1);
+        REQUIRE_NOTHROW(randomOctaveTestObject.clear("Bb4", Inlets::ARGS));
+        REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
+    }
+
+    GIVEN("bad clear arguments") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ 62, 100 }, Inlets::NOTE)); // NOLINT
+
+        THEN("they are ignored without throwing") {
+            REQUIRE_NOTHROW(randomOctaveTestObject.clear("D", Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.clear("sixty", Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.clear("99999999999", Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.clear(200, Inlets::ARGS)); // NOLINT
+            REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 1);
+        }
+    }
 };
 
 SCENARIO("seidr.RandomOctaveMax test different types of inputs") { // NOLINT
@@ -461,3 +487,609 @@ SCENARIO("seidr.RandomOctaveMax test different types of inputs") { // NOLINT
         REQUIRE(randomOctaveTestObject.getQueuedNotes().empty());
     }
 }
+
+SCENARIO("seidr.RandomOctaveMax weighted octaves") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(randomOctaveTestObject, 0);
+
+    GIVEN("a range of three octaves") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.range({ NoteC4, NoteC7 - 1 }, Inlets::ARGS));
+
+        WHEN("only the middle octave has a weight") {
+            REQUIRE_NOTHROW(randomOctaveTestObject.weights({ 0, 1, 0 }, Inlets::ARGS));
+            REQUIRE(randomOctaveTestObject.isWeighted());
+
+            for (int i = 0; i < 20; i++) { // NOLINT
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4 + (i % OCTAVE), 100 }, Inlets::NOTE));
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4 + (i % OCTAVE), 0 }, Inlets::NOTE));
+            }
+
+            THEN("every note is played in that octave") {
+                REQUIRE(!note_output.empty());
+
+                for (const auto &output : note_output) {
+                    REQUIRE(static_cast<int>(output[0]) >= NoteC5);
+                    REQUIRE(static_cast<int>(output[0]) < NoteC6);
+                }
+            }
+        }
+
+        WHEN("a pitch class only has octaves without a weight") {
+            REQUIRE_NOTHROW(randomOctaveTestObject.range({ NoteC4 + 6, NoteC6 + 5 }, Inlets::ARGS)); // NOLINT
+            REQUIRE_NOTHROW(randomOctaveTestObject.weights({ 1, 0, 0 }, Inlets::ARGS));
+
+            REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC5, 100 }, Inlets::NOTE));
+
+            THEN("the note is not played") {
+                REQUIRE(note_output.empty());
+            }
+
+            THEN("a pitch class with a weighted octave is still played") {
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC5 + 7, 100 }, Inlets::NOTE)); // NOLINT
+
+                REQUIRE(note_output.size() == 1);
+                REQUIRE(static_cast<int>(note_output[0][0]) == NoteC4 + 7);
+            }
+        }
+
+        WHEN("the range changes again before a note") {
+            // Every change is built into the tables notes aren't using.
+            REQUIRE_NOTHROW(randomOctaveTestObject.range({ NoteC5, NoteC6 - 1 }, Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.range({ NoteC6, NoteC7 - 1 }, Inlets::ARGS));
+
+            for (int i = 0; i < 20; i++) { // NOLINT
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4 + (i % OCTAVE), 100 }, Inlets::NOTE));
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4 + (i % OCTAVE), 0 }, Inlets::NOTE));
+            }
+
+            THEN("every note is played in the last range") {
+                REQUIRE(!note_output.empty());
+
+                for (const auto &output : note_output) {
+                    REQUIRE(static_cast<int>(output[0]) >= NoteC6);
+                    REQUIRE(static_cast<int>(output[0]) < NoteC7);
+                }
+            }
+        }
+
+        WHEN("the weights are cleared") {
+            REQUIRE_NOTHROW(randomOctaveTestObject.weights({ 0, 1, 0 }, Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.weights(min::atoms{}, Inlets::ARGS));
+
+            THEN("the octaves are even again") {
+                REQUIRE(!randomOctaveTestObject.isWeighted());
+            }
+        }
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax note off matching") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(randomOctaveTestObject, 0);
+
+    GIVEN("a key that is retriggered") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 100 }, Inlets::NOTE));
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 90 }, Inlets::NOTE));
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteE4, 80 }, Inlets::NOTE));
+        REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 3);
+
+        WHEN("the key is released") {
+            note_output.clear();
+            REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 0 }, Inlets::NOTE));
+
+            THEN("every pitch sent for it is turned off") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(MIDI::getPitchClass(note_output[0][0]) == 0);
+                REQUIRE(MIDI::getPitchClass(note_output[1][0]) == 0);
+                REQUIRE(note_output[0][1] == 0);
+                REQUIRE(note_output[1][1] == 0);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 1);
+                REQUIRE(randomOctaveTestObject.getQueuedNotes().empty());
+            }
+        }
+
+        WHEN("the key is retriggered more times than there are slots") {
+            for (int i = 0; i < NoteIndex::SLOTS; i++) {
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 100 }, Inlets::NOTE));
+            }
+
+            THEN("the oldest notes are turned off") {
+                REQUIRE(randomOctaveTestObject.getActiveNotes().size() == NoteIndex::SLOTS + 1);
+            }
+        }
+    }
+
+    GIVEN("a note off for a key that was never played") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteA4, 0 }, Inlets::NOTE));
+
+        THEN("the note off is passed through") {
+            REQUIRE(note_output.size() == 1);
+            REQUIRE(note_output[0][0] == NoteA4);
+            REQUIRE(note_output[0][1] == 0);
+        }
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax polyphony") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(randomOctaveTestObject, 0);
+
+    GIVEN("a polyphony of two") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.polyphony(2, Inlets::ARGS));
+        REQUIRE(randomOctaveTestObject.getPolyphony() == 2);
+
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 100 }, Inlets::NOTE));
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteE4, 100 }, Inlets::NOTE));
+
+        WHEN("a third note is played") {
+            note_output.clear();
+            REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteG4, 100 }, Inlets::NOTE));
+
+            THEN("the oldest note is turned off before the new note") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(MIDI::getPitchClass(note_output[0][0]) == 0);
+                REQUIRE(note_output[0][1] == 0);
+                REQUIRE(MIDI::getPitchClass(note_output[1][0]) == 7); // NOLINT
+                REQUIRE(note_output[1][1] == 100);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 2);
+            }
+
+            THEN("the stolen note off is not sent again") {
+                note_output.clear();
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteE4, 0 }, Inlets::NOTE));
+                REQUIRE(note_output.size() == 1);
+                REQUIRE(MIDI::getPitchClass(note_output[0][0]) == 4); // NOLINT
+            }
+
+            THEN("the note off of the stolen key is dropped") {
+                note_output.clear();
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 0 }, Inlets::NOTE));
+                REQUIRE(note_output.empty());
+            }
+
+            THEN("a key pressed again after it was stolen is released as usual") {
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 0 }, Inlets::NOTE));
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 100 }, Inlets::NOTE));
+                note_output.clear();
+
+                REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 0 }, Inlets::NOTE));
+                REQUIRE(note_output.size() == 1);
+                REQUIRE(MIDI::getPitchClass(note_output[0][0]) == 0);
+                REQUIRE(note_output[0][1] == 0);
+            }
+        }
+
+        WHEN("the polyphony is lowered") {
+            note_output.clear();
+            REQUIRE_NOTHROW(randomOctaveTestObject.polyphony(1, Inlets::ARGS));
+
+            THEN("the oldest notes are turned off") {
+                REQUIRE(note_output.size() == 1);
+                REQUIRE(MIDI::getPitchClass(note_output[0][0]) == 0);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 1);
+            }
+        }
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax duration mode") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(randomOctaveTestObject, 0);
+
+    GIVEN("a duration of 100 ms") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.duration(100, Inlets::ARGS)); // NOLINT
+        REQUIRE(randomOctaveTestObject.getDuration() == 100);
+
+        uint32_t start = RandomOctaveMax::now();
+
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 100 }, Inlets::NOTE));
+        REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteE4, 100 }, Inlets::NOTE));
+        REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 2);
+
+        WHEN("the duration has passed") {
+            note_output.clear();
+            randomOctaveTestObject.expireNotes(start + 1000); // NOLINT
+
+            THEN("every note is turned off") {
+                REQUIRE(note_output.size() == 2);
+                REQUIRE(note_output[0][1] == 0);
+                REQUIRE(note_output[1][1] == 0);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
+            }
+        }
+
+        WHEN("a note off arrives before the duration has passed") {
+            REQUIRE_NOTHROW(randomOctaveTestObject.list({ NoteC4, 0 }, Inlets::NOTE));
+            note_output.clear();
+            randomOctaveTestObject.expireNotes(start + 1000); // NOLINT
+
+            THEN("the note is only turned off once") {
+                REQUIRE(note_output.size() == 1);
+                REQUIRE(MIDI::getPitchClass(note_output[0][0]) == 4); // NOLINT
+            }
+        }
+    }
+
+    GIVEN("a timer wheel with note offs at different times") {
+        TimerWheel<NoteIndex::VOICES> wheel;
+        std::vector<int> expired;
+
+        wheel.advance(1000, [](int) {}); // NOLINT
+        wheel.schedule(0, 300); // NOLINT
+        wheel.schedule(1, 40); // NOLINT
+        wheel.schedule(2, 700); // NOLINT
+
+        THEN("the next tick is due when the first note off is") {
+            REQUIRE(wheel.nextDue() == 40);
+        }
+
+        WHEN("the wheel is moved to the first note off") {
+            wheel.advance(1040, [&expired](int timer) { expired.push_back(timer); }); // NOLINT
+
+            THEN("only that note is turned off and the next one is due after it") {
+                REQUIRE(expired == std::vector<int> {1});
+                REQUIRE(wheel.nextDue() == 260);
+            }
+        }
+
+        WHEN("every note off is cancelled") {
+            wheel.cancel(0);
+            wheel.cancel(1);
+            wheel.cancel(2);
+
+            THEN("nothing is due and the timer can stop") {
+                REQUIRE(wheel.empty());
+                REQUIRE(wheel.nextDue() == 0);
+            }
+        }
+    }
+
+    GIVEN("a far note off that comes due before a near one scheduled later") {
+        TimerWheel<NoteIndex::VOICES> wheel;
+        std::vector<int> expired;
+
+        wheel.schedule(0, 300); // NOLINT
+        wheel.advance(200, [](int) {}); // NOLINT
+        wheel.schedule(1, 200); // NOLINT
+
+        THEN("the far one in the second level is due first") {
+            REQUIRE(wheel.nextDue() == 100);
+        }
+
+        WHEN("the wheel is moved to it") {
+            wheel.advance(300, [&expired](int timer) { expired.push_back(timer); }); // NOLINT
+
+            THEN("the near one is due next") {
+                REQUIRE(expired == std::vector<int> {0});
+                REQUIRE(wheel.nextDue() == 100);
+            }
+        }
+    }
+
+    GIVEN("a timer wheel scheduled, cancelled and moved at random") {
+        TimerWheel<NoteIndex::VOICES> wheel;
+        std::array<uint32_t, NoteIndex::VOICES> due = {};
+        std::array<bool, NoteIndex::VOICES> scheduled = {};
+        std::mt19937 random(7); // NOLINT
+        uint32_t now = 0;
+        int mismatches = 0;
+
+        for (int i = 0; i < 20000; i++) { // NOLINT
+            int timer = static_cast<int>(random() % NoteIndex::VOICES);
+
+            switch (random() % 3) {
+            case 0: {
+                // Mostly near note offs, some far ones past the first level.
+                uint32_t delay = ((random() % 4) == 0) ? random() % 70000 : 1 + (random() % 300); // NOLINT
+                wheel.schedule(timer, delay);
+                due[timer] = now + std::clamp<uint32_t>(delay, 1, TimerWheel<NoteIndex::VOICES>::SPAN - 1);
+                scheduled[timer] = true;
+                break;
+            }
+            case 1:
+                wheel.cancel(timer);
+                scheduled[timer] = false;
+                break;
+            default:
+                now += random() % 400; // NOLINT
+                wheel.advance(now, [&scheduled](int expiredTimer) { scheduled[expiredTimer] = false; });
+                break;
+            }
+
+            uint32_t next = 0;
+
+            for (int voice = 0; voice < NoteIndex::VOICES; voice++) {
+                if (scheduled[voice]) {
+                    uint32_t delay = due[voice] - now;
+                    next = ((next == 0) || (delay < next)) ? delay : next;
+                }
+            }
+
+            mismatches += (wheel.nextDue() == next) ? 0 : 1;
+        }
+
+        THEN("the next tick due is always the first of the timers") {
+            REQUIRE(mismatches == 0);
+        }
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax reads and sends raw MIDI bytes") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(randomOctaveTestObject, 0);
+
+    GIVEN("raw mode and a one octave range") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.range({ NoteC4, NoteB4 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(randomOctaveTestObject.raw(1, Inlets::ARGS));
+        REQUIRE(randomOctaveTestObject.isRaw());
+
+        WHEN("a note on and a note off are sent on channel 2") {
+            for (int byte : { 0x91, int(NoteC5), 100, 0x81, int(NoteC5), 64 }) { // NOLINT
+                REQUIRE_NOTHROW(randomOctaveTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            THEN("the notes are sent as bytes on the same channel") {
+                REQUIRE(note_output.size() == 6);
+                REQUIRE(note_output[0][0] == 0x91);
+                REQUIRE(note_output[1][0] == NoteC4);
+                REQUIRE(note_output[2][0] == 100);
+                REQUIRE(note_output[3][0] == 0x91);
+                REQUIRE(note_output[4][0] == NoteC4);
+                REQUIRE(note_output[5][0] == 0);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
+            }
+        }
+
+        WHEN("the same note is played on channels 1 and 2 and released on channel 2 first") {
+            for (int byte : { 0x90, int(NoteC5), 100, 0x91, int(NoteC5), 90, 0x81, int(NoteC5), 0 }) { // NOLINT
+                REQUIRE_NOTHROW(randomOctaveTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            THEN("only the voice on channel 2 is turned off, on channel 2") {
+                REQUIRE(note_output.size() == 9);
+                REQUIRE(note_output[0][0] == 0x90);
+                REQUIRE(note_output[3][0] == 0x91);
+                REQUIRE(note_output[6][0] == 0x91);
+                REQUIRE(note_output[7][0] == NoteC4);
+                REQUIRE(note_output[8][0] == 0);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().size() == 1);
+            }
+
+            AND_WHEN("the note is released on channel 1") {
+                for (int byte : { 0x80, int(NoteC5), 0 }) { // NOLINT
+                    REQUIRE_NOTHROW(randomOctaveTestObject.integerInput(byte, Inlets::NOTE));
+                }
+
+                THEN("its note off goes out on channel 1") {
+                    REQUIRE(note_output.size() == 12);
+                    REQUIRE(note_output[9][0] == 0x90);
+                    REQUIRE(note_output[10][0] == NoteC4);
+                    REQUIRE(note_output[11][0] == 0);
+                    REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
+                }
+            }
+        }
+
+        WHEN("notes on two channels are stolen by a lower polyphony") {
+            for (int byte : { 0x92, int(NoteC5), 100, 0x93, int(NoteD5), 100 }) { // NOLINT
+                REQUIRE_NOTHROW(randomOctaveTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            REQUIRE_NOTHROW(randomOctaveTestObject.polyphony(1, Inlets::ARGS));
+
+            THEN("the stolen note is turned off on its own channel") {
+                REQUIRE(note_output.size() == 9);
+                REQUIRE(note_output[6][0] == 0x92);
+                REQUIRE(note_output[7][0] == NoteC4);
+                REQUIRE(note_output[8][0] == 0);
+            }
+        }
+
+        WHEN("a pitch bend is sent") {
+            for (int byte : { 0xE0, 0, 64 }) { // NOLINT
+                REQUIRE_NOTHROW(randomOctaveTestObject.integerInput(byte, Inlets::NOTE));
+            }
+
+            THEN("it is passed through") {
+                REQUIRE(note_output.size() == 3);
+                REQUIRE(note_output[0][0] == 0xE0);
+                REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
+            }
+        }
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax records its messages and plays them back") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> recorded_instance;
+    RandomOctaveMax &recorded = recorded_instance;
+    min::test_wrapper<RandomOctaveMax> replayed_instance;
+    RandomOctaveMax &replayed = replayed_instance;
+
+    auto &recorded_output = *c74::max::object_getoutput(recorded, 0);
+    auto &replayed_output = *c74::max::object_getoutput(replayed, 0);
+
+    std::string path = (std::filesystem::temp_directory_path() / "seidr.RandomOctave_test.log").string();
+
+    GIVEN("a recording of a few messages") {
+        REQUIRE_NOTHROW(recorded.record({ path }, Inlets::ARGS));
+
+        REQUIRE_NOTHROW(recorded.range({ NoteC4, NoteB4 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(recorded.polyphony(2, Inlets::ARGS));
+        REQUIRE_NOTHROW(recorded.list({ NoteC5, 100 }, Inlets::NOTE));
+        REQUIRE_NOTHROW(recorded.list({ NoteE5, 90 }, Inlets::NOTE)); // NOLINT
+        REQUIRE_NOTHROW(recorded.list({ NoteG5, 80 }, Inlets::NOTE)); // NOLINT
+        REQUIRE_NOTHROW(recorded.clear({ "all" }, Inlets::ARGS));
+
+        REQUIRE_NOTHROW(recorded.record(min::atoms {}, Inlets::ARGS));
+
+        WHEN("the recording is played back into another object") {
+            int count = MessageRecorder::replay(replayed, path);
+
+            THEN("the other object sends the same notes") {
+                REQUIRE(count == 6);
+                REQUIRE(replayed.getPolyphony() == 2);
+                REQUIRE(replayed_output.size() == recorded_output.size());
+
+                for (size_t i = 0; i < recorded_output.size(); i++) {
+                    REQUIRE(replayed_output[i][0] == recorded_output[i][0]);
+                    REQUIRE(replayed_output[i][1] == recorded_output[i][1]);
+                }
+            }
+        }
+
+        WHEN("the memory used is asked for") {
+            THEN("the recording buffer is counted") {
+                REQUIRE(recorded.memoryUsage() >= sizeof(RandomOctaveMax) + MessageLog::RING_SIZE);
+                REQUIRE(replayed.memoryUsage() < sizeof(RandomOctaveMax) + MessageLog::RING_SIZE);
+            }
+        }
+
+        std::filesystem::remove(path);
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax saves and recalls its state") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    GIVEN("a weighted range, polyphony and a duration") {
+        REQUIRE_NOTHROW(randomOctaveTestObject.range({ NoteC4, NoteC6 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(randomOctaveTestObject.weights({ 1, 0, 2 }, Inlets::ARGS));
+        REQUIRE_NOTHROW(randomOctaveTestObject.polyphony(3, Inlets::ARGS));
+        REQUIRE_NOTHROW(randomOctaveTestObject.duration(250, Inlets::ARGS)); // NOLINT
+
+        WHEN("the state is stored, changed and recalled") {
+            REQUIRE_NOTHROW(randomOctaveTestObject.store(0, Inlets::ARGS));
+
+            REQUIRE_NOTHROW(randomOctaveTestObject.weights(min::atoms {}, Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.polyphony(8, Inlets::ARGS)); // NOLINT
+            REQUIRE_NOTHROW(randomOctaveTestObject.duration(0, Inlets::ARGS));
+            REQUIRE_NOTHROW(randomOctaveTestObject.raw(1, Inlets::ARGS));
+
+            REQUIRE_NOTHROW(randomOctaveTestObject.recall(0, Inlets::ARGS));
+
+            THEN("the stored settings are back") {
+                REQUIRE(randomOctaveTestObject.isWeighted());
+                REQUIRE(randomOctaveTestObject.getPolyphony() == 3);
+                REQUIRE(randomOctaveTestObject.getDuration() == 250);
+                REQUIRE(!randomOctaveTestObject.isRaw());
+            }
+        }
+
+        WHEN("a snapshot is restored into another object") {
+            min::test_wrapper<RandomOctaveMax> other_instance;
+            RandomOctaveMax &otherObject = other_instance;
+            auto &note_output = *c74::max::object_getoutput(otherObject, 0);
+
+            auto snapshot = randomOctaveTestObject.snapshot();
+            StateReader reader(snapshot);
+            REQUIRE(otherObject.restore(reader));
+
+            THEN("notes only land in the weighted octaves") {
+                for (int i = 0; i < 50; i++) { // NOLINT
+                    REQUIRE_NOTHROW(otherObject.list({ NoteC5, 100 }, Inlets::NOTE)); // NOLINT
+                    REQUIRE_NOTHROW(otherObject.list({ NoteC5, 0 }, Inlets::NOTE));
+                }
+
+                for (const auto &note : note_output) {
+                    int pitch = static_cast<int>(note[0]);
+                    REQUIRE(((pitch == NoteC4) || (pitch == NoteC6)));
+                }
+
+                REQUIRE(otherObject.getPolyphony() == 3);
+            }
+        }
+
+        WHEN("an empty slot is recalled") {
+            THEN("nothing is restored") {
+                REQUIRE_FALSE(randomOctaveTestObject.recallSlot(7)); // NOLINT
+                REQUIRE_FALSE(randomOctaveTestObject.recallSlot(-1));
+                REQUIRE(randomOctaveTestObject.getDuration() == 250);
+            }
+        }
+    }
+}
+
+SCENARIO("seidr.RandomOctaveMax under concurrent messages", "[.stress]") { // NOLINT
+    ext_main(nullptr);
+
+    min::test_wrapper<RandomOctaveMax> an_instance;
+    RandomOctaveMax &randomOctaveTestObject = an_instance;
+
+    auto &note_output = *c74::max::object_getoutput(randomOctaveTestObject, 0);
+
+    // Every note in is turned off again. A note whose pitch class has no
+    // weighted octave in the range is not played, its note off still is.
+    uint64_t noteOns = 0;
+    uint64_t noteOffs = 0;
+    uint64_t invalid = 0;
+
+    auto drain = [&] {
+        for (const auto &entry : note_output) {
+            int pitch = static_cast<int>(entry[entry.size() - 2]);
+            int velocity = static_cast<int>(entry.back());
+
+            invalid += ((pitch >= MIDI::RANGE_LOW) && (pitch <= MIDI::RANGE_HIGH)) ? 0 : 1;
+            (velocity > 0) ? noteOns++ : noteOffs++;
+        }
+
+        note_output.clear();
+    };
+
+    StressRunner stress(100000); // NOLINT
+
+    stress.scheduler("list", [&](uint64_t n) {
+        int note = static_cast<int>(n % 128); // NOLINT
+        randomOctaveTestObject.list({ note, 100 }, Inlets::NOTE); // NOLINT
+        randomOctaveTestObject.list({ note, 0 }, Inlets::NOTE);
+    }, drain);
+
+    stress.main("range", [&](uint64_t n) {
+        int low = static_cast<int>(n % 64); // NOLINT
+        randomOctaveTestObject.range({ low, low + 63 }, Inlets::ARGS); // NOLINT
+    });
+
+    stress.main("weights", [&](uint64_t n) {
+        randomOctaveTestObject.weights({ 1, static_cast<int>(n % 4), 2 }, Inlets::ARGS); // NOLINT
+    });
+
+    StressRunner::report("seidr.RandomOctave", stress.run(), std::cout);
+
+    THEN("every note was turned off in the MIDI range and the state can be read") {
+        REQUIRE(noteOffs == 100000); // NOLINT
+        REQUIRE(noteOns > 0);
+        REQUIRE(noteOns <= noteOffs);
+        REQUIRE(invalid == 0);
+        REQUIRE(randomOctaveTestObject.getActiveNotes().empty());
+
+        std::vector<uint8_t> state = randomOctaveTestObject.snapshot();
+        StateReader reader(state);
+
+        REQUIRE(reader.isValid());
+        REQUIRE(randomOctaveTestObject.restore(reader));
+    }
+}
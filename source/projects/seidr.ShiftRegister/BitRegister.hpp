@@ -0,0 +1,100 @@
+/// @file       BitRegister.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+// A shift register of up to 32 bits held in one word.
+//
+// The first stage is the lowest bit. A step is a shift and an or, and a
+// jump of many steps with the same data input is worked out in one go, so
+// the cost doesn't grow with the number of steps. The whole state can be
+// read and written, for snapshots. The data input can be set on another
+// thread than the one stepping.
+class BitRegister {
+public:
+    enum : uint8_t {
+        MAX_BITS = 32
+    };
+
+    explicit BitRegister(int bits = 8) { // NOLINT
+        this->bits_ = std::clamp(bits, 1, static_cast<int>(MAX_BITS));
+        this->mask_ = (uint64_t{1} << this->bits_) - 1;
+    }
+
+    // Shift the data input into the first stage, the last stage falls out
+    // as the data through.
+    auto step() -> int {
+        this->through_ = static_cast<uint8_t>((this->word_ >> (this->bits_ - 1)) & 1U);
+        this->word_ = ((this->word_ << 1U) | this->input_.load(std::memory_order_relaxed)) & this->mask_;
+        return this->through_;
+    }
+
+    // The same as count steps with the same data input. The first count
+    // stages get the input, and the stage count - 1 before the last one is
+    // the last to fall out. After more steps than there are stages the data
+    // input has come through as well.
+    auto step(int count) -> int {
+        if (count <= 0) {
+            return this->through_;
+        }
+
+        uint8_t input = this->input_.load(std::memory_order_relaxed);
+        uint64_t filled = (input != 0) ? this->mask_ : 0;
+
+        if (count > this->bits_) {
+            this->word_ = filled;
+            this->through_ = input;
+            return this->through_;
+        }
+
+        this->through_ = static_cast<uint8_t>((this->word_ >> (this->bits_ - count)) & 1U);
+        this->word_ = ((this->word_ << static_cast<unsigned int>(count)) | (filled & ((uint64_t{1} << count) - 1))) & this->mask_;
+        return this->through_;
+    }
+
+    // Every stage and the data through to zero, the data input is kept.
+    auto clear() -> void {
+        this->word_ = 0;
+        this->through_ = 0;
+    }
+
+    [[nodiscard]] auto get(int stage) const -> int {
+        if ((stage < 0) || (stage >= this->bits_)) {
+            return 0;
+        }
+
+        return static_cast<int>((this->word_ >> stage) & 1U);
+    }
+
+    auto dataInput(int value) -> int {
+        uint8_t input = (value != 0) ? 1 : 0;
+        this->input_.store(input, std::memory_order_relaxed);
+        return input;
+    }
+
+    [[nodiscard]] auto input() const -> int { return this->input_.load(std::memory_order_relaxed); }
+    [[nodiscard]] auto dataThrough() const -> int { return this->through_; }
+    [[nodiscard]] auto size() const -> int { return this->bits_; }
+    [[nodiscard]] auto word() const -> uint32_t { return static_cast<uint32_t>(this->word_); }
+
+    // Take over a state from word(), input() and dataThrough().
+    auto load(uint32_t word, int input, int through) -> void {
+        this->word_ = word & this->mask_;
+        this->input_.store((input != 0) ? 1 : 0, std::memory_order_relaxed);
+        this->through_ = (through != 0) ? 1 : 0;
+    }
+
+private:
+    uint64_t word_ = 0;
+    uint64_t mask_ = 0;
+    int bits_ = 0;
+    std::atomic<uint8_t> input_ {0};
+    uint8_t through_ = 0;
+};
@@ -0,0 +1,123 @@
+/// @file       ValueRegister.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+#include <vector>
+
+// A shift register where every stage holds a whole value.
+//
+// The stages are a ring buffer and a step only moves the head back by one,
+// so stepping costs the same however many stages there are. The data input
+// can be set on another thread than the one stepping.
+class ValueRegister {
+public:
+    enum : int {
+        MAX_LENGTH = 4096
+    };
+
+    explicit ValueRegister(int length = 8) { this->setLength(length); } // NOLINT
+
+    // Change the number of stages, every stage is set to zero.
+    auto setLength(int length) -> void {
+        this->stages_.assign(std::clamp(length, 1, static_cast<int>(MAX_LENGTH)), 0);
+        this->head_ = 0;
+        this->through_ = 0;
+    }
+
+    // Shift the data input into the first stage, the value in the last
+    // stage falls out as the data through.
+    auto step() -> int {
+        this->head_ = (this->head_ == 0) ? this->size() - 1 : this->head_ - 1;
+        this->through_ = this->stages_[this->head_];
+        this->stages_[this->head_] = this->input();
+        return this->through_;
+    }
+
+    // Step count times with the same data input. Only the stages that get
+    // the input are written, and after more steps than there are stages
+    // the data input has also come through.
+    auto step(int count) -> int {
+        if (count <= 0) {
+            return this->through_;
+        }
+
+        int input = this->input();
+
+        if (count > this->size()) {
+            std::fill(this->stages_.begin(), this->stages_.end(), input);
+            this->through_ = input;
+            return this->through_;
+        }
+
+        this->through_ = this->get(this->size() - count);
+
+        for (int i = 0; i < count; i++) {
+            this->head_ = (this->head_ == 0) ? this->size() - 1 : this->head_ - 1;
+            this->stages_[this->head_] = input;
+        }
+
+        return this->through_;
+    }
+
+    // Every stage and the data through to zero, the data input is kept.
+    auto clear() -> void {
+        std::fill(this->stages_.begin(), this->stages_.end(), 0);
+        this->head_ = 0;
+        this->through_ = 0;
+    }
+
+    [[nodiscard]] auto get(int stage) const -> int {
+        if ((stage < 0) || (stage >= this->size())) {
+            return 0;
+        }
+
+        int index = this->head_ + stage;
+        return this->stages_[(index >= this->size()) ? index - this->size() : index];
+    }
+
+    auto dataInput(int value) -> int {
+        this->input_.store(value, std::memory_order_relaxed);
+        return value;
+    }
+
+    [[nodiscard]] auto input() const -> int { return this->input_.load(std::memory_order_relaxed); }
+    [[nodiscard]] auto dataThrough() const -> int { return this->through_; }
+    [[nodiscard]] auto size() const -> int { return static_cast<int>(this->stages_.size()); }
+
+    // The stages from the first to the last.
+    [[nodiscard]] auto stages() const -> std::vector<int> {
+        std::vector<int> values(this->stages_.size());
+
+        for (int stage = 0; stage < this->size(); stage++) {
+            values[stage] = this->get(stage);
+        }
+
+        return values;
+    }
+
+    // Take over stages from stages(), the length follows the number of
+    // stages.
+    auto load(std::vector<int> stages, int input, int through) -> void {
+        if (stages.empty() || (stages.size() > MAX_LENGTH)) {
+            stages.resize(std::clamp(static_cast<int>(stages.size()), 1, static_cast<int>(MAX_LENGTH)));
+        }
+
+        this->stages_ = std::move(stages);
+        this->head_ = 0;
+        this->input_.store(input, std::memory_order_relaxed);
+        this->through_ = through;
+    }
+
+private:
+    std::vector<int> stages_;
+    int head_ = 0;
+    std::atomic<int> input_ {0};
+    int through_ = 0;
+};
@@ -5,6 +5,7 @@
 ///             found in the License.md file.
 
 #include "seidr.ShiftRegister.hpp"
+#include <algorithm>
 
 using namespace c74::min;
 
@@ -15,55 +16,216 @@ ShiftRegisterMax::ShiftRegisterMax(const atoms &args) {
         numberOfOutputs = args[0];
     }
 
-    if (numberOfOutputs > 0) {
-        for (int i = 0; i < numberOfOutputs; i++) {
-            outputs.push_back(
-                std::make_unique<outlet<>>(this, "(int | bang) output " + std::to_string(i)));
+    // One stage for each output, the last output is the data through.
+    this->values_.setLength(numberOfOutputs - 1);
+
+    static OutletNames names("(int | bang) output ");
+    this->outputs.create(this, numberOfOutputs, names);
+
+    // State saved with the patcher.
+    StateSnapshot::load(this->state(), this->slots_, [this](StateReader &reader) { return this->restore(reader); });
+};
+
+auto ShiftRegisterMax::snapshot() -> std::vector<uint8_t> {
+    StateWriter writer(STATE_VERSION);
+    writer.write(this->valueMode_);
+    writer.write(this->everyOutput);
+    writer.write(this->sendBangs);
+
+    writer.write(this->sr_.word());
+    writer.write(this->sr_.input());
+    writer.write(this->sr_.dataThrough());
+
+    std::vector<int> values = this->values_.stages();
+    writer.writeArray(values.data(), values.size());
+    writer.write(this->values_.input());
+    writer.write(this->values_.dataThrough());
+    return std::move(writer.bytes());
+}
+
+auto ShiftRegisterMax::restore(StateReader &reader) -> bool {
+    bool valueMode = false;
+    bool everyOutput = true;
+    bool sendBangs = false;
+    uint32_t bitWord = 0;
+    int bitInput = 0;
+    int bitThrough = 0;
+    std::vector<int> values;
+    int valueInput = 0;
+    int valueThrough = 0;
+
+    if ((reader.version() < 1) || (reader.version() > STATE_VERSION) || !reader.read(valueMode) || !reader.read(everyOutput) ||
+        !reader.read(sendBangs)) {
+        return false;
+    }
+
+    // Version 1 kept one byte for every bit stage and no bit data through.
+    if (reader.version() == 1) {
+        std::vector<uint8_t> bits;
+
+        if (!reader.readArray(bits, MAX_OUTPUTS) || !reader.read(bitInput)) {
+            return false;
+        }
+
+        for (size_t i = 0; i < bits.size(); i++) {
+            bitWord |= static_cast<uint32_t>(bits[i] != 0) << i;
         }
+    } else if (!reader.read(bitWord) || !reader.read(bitInput) || !reader.read(bitThrough)) {
+        return false;
     }
-};
+
+    if (!reader.readArray(values, ValueRegister::MAX_LENGTH) || !reader.read(valueInput) || !reader.read(valueThrough)) {
+        return false;
+    }
+
+    this->sr_.load(bitWord, bitInput, bitThrough);
+
+    this->pendingLength_.store(0, std::memory_order_relaxed);
+    this->values_.load(std::move(values), valueInput, valueThrough);
+    this->valueMode_ = valueMode;
+    this->everyOutput = everyOutput;
+    this->sendBangs = sendBangs;
+    return true;
+}
+
+auto ShiftRegisterMax::recallSlot(int slot) -> bool {
+    return this->slots_.recall(slot, [this](StateReader &reader) { return this->restore(reader); });
+}
 
 void ShiftRegisterMax::handleOutputs() {
     // Bit outputs from 0 to (N-1).
     for (int i = 0; i < outputs.size() - 1; i++) {
-        this->outputs[i]->send(this->sendBangs ? bang() : atoms{(uint64_t)this->sr_.get(i)}); // NOLINT
+        this->outputs[i].send(this->sendBangs ? bang() : atoms{(uint64_t)this->get(i)}); // NOLINT
     }
 }
 
 void ShiftRegisterMax::handleThrough() {
     // Output N data through.
-    auto currentDataThrough = (uint64_t)this->sr_.dataThrough();
-    unsigned int lastOutputIndex = outputs.size() - 1;
+    int currentDataThrough = this->dataThrough();
 
-    if (everyOutput || currentDataThrough != lastOutput[8].get()) { // NOLINT
-        this->outputs[lastOutputIndex]->send(this->sendBangs ? bang() : c74::min::atoms(currentDataThrough));
-        this->lastOutput[lastOutputIndex].set(currentDataThrough);
+    if (this->outputs.empty()) {
+        return;
     }
 
-    LastNote x = LastNote(); // NOLINT
-    x.set(currentDataThrough);
+    if (this->everyOutput || (currentDataThrough != this->lastThrough_)) {
+        this->outputs[this->outputs.size() - 1].send(this->sendBangs ? bang() : atoms{currentDataThrough});
+    }
+
+    this->lastThrough_ = currentDataThrough;
+}
 
-    this->lastOutput[8] = x; // NOLINT
+auto ShiftRegisterMax::memoryUsage() const -> size_t {
+    return sizeof(*this) + this->outputs.bytes() + (this->values_.size() * sizeof(int)) + this->slots_.bytes();
 }
 
 auto ShiftRegisterMax::size() -> int {
-    return this->sr_.size();
+    return this->valueMode_ ? this->values_.size() : this->sr_.size();
+}
+
+auto ShiftRegisterMax::applyLength() -> void {
+    int length = this->pendingLength_.exchange(0, std::memory_order_relaxed);
+
+    if (length > 0) {
+        this->values_.setLength(length);
+    }
 }
 
 auto ShiftRegisterMax::step() -> int {
-    return this->sr_.step();
+    this->applyLength();
+    return this->valueMode_ ? this->values_.step() : this->sr_.step();
+}
+
+auto ShiftRegisterMax::stepBy(int steps) -> int {
+    this->applyLength();
+    return this->valueMode_ ? this->values_.step(steps) : this->sr_.step(steps);
+}
+
+// A shift register has no count to reset, it is cleared and stepped on.
+auto ShiftRegisterMax::locateAt(int position) -> int {
+    if (position < 0) {
+        return this->dataThrough();
+    }
+
+    if (this->valueMode_) {
+        this->applyLength();
+        this->values_.clear();
+        return this->values_.step(position);
+    }
+
+    this->sr_.clear();
+    return this->sr_.step(position);
+}
+
+auto ShiftRegisterMax::pulse() -> void {
+    bool stepped = this->budget_.run(EventBudget::now(), [this] {
+        // Steps merged in an earlier tick go first.
+        this->flush();
+        this->step();
+        this->handleThrough();
+    });
+
+    if (!stepped) {
+        this->budget_.shed();
+
+        if (this->pendingSteps_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            this->flush_tick.delay(0);
+        }
+    }
+}
+
+auto ShiftRegisterMax::activate() -> void {
+    bool sent = this->budget_.run(EventBudget::now(), [this] {
+        this->flush();
+        this->handleOutputs();
+    });
+
+    // Only the last state of the outputs matters, send it once.
+    if (!sent) {
+        this->budget_.shed();
+
+        if (!this->pendingOutputs_.exchange(true, std::memory_order_relaxed)) {
+            this->flush_tick.delay(0);
+        }
+    }
+}
+
+auto ShiftRegisterMax::flush() -> void {
+    this->applyLength();
+
+    uint32_t steps = this->pendingSteps_.exchange(0, std::memory_order_relaxed);
+
+    if (steps > 0) {
+        this->stepBy(static_cast<int>(steps));
+        this->handleThrough();
+    }
+
+    if (this->pendingOutputs_.exchange(false, std::memory_order_relaxed)) {
+        this->handleOutputs();
+    }
+}
+
+auto ShiftRegisterMax::setBudget(int events, int microseconds) -> void {
+    this->budget_.set(static_cast<uint32_t>(std::max(events, 0)), static_cast<uint32_t>(std::max(microseconds, 0)));
 }
 
 auto ShiftRegisterMax::get(int index) -> int {
-    return this->sr_.get(index);
+    return this->valueMode_ ? this->values_.get(index) : this->sr_.get(index);
 }
 
 auto ShiftRegisterMax::dataInput(int value) -> int {
+    if (this->valueMode_) {
+        return this->values_.dataInput(value);
+    }
+
     return this->sr_.dataInput(value);
 }
 
+auto ShiftRegisterMax::setValueMode(bool enabled) -> void {
+    this->valueMode_ = enabled;
+}
+
 auto ShiftRegisterMax::dataThrough() -> int {
-    return this->sr_.dataThrough();
+    return this->valueMode_ ? this->values_.dataThrough() : this->sr_.dataThrough();
 }
 
 MIN_EXTERNAL(ShiftRegisterMax); // NOLINT
@@ -6,33 +6,32 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <c74_min.h>
-#include "ShiftRegister/ShiftRegister.hpp"
+#include "ClockFollower.hpp"
+#include "InternalClock.hpp"
+#include "EventBudget.hpp"
+#include "MessageArgs.hpp"
+#include "OutletArray.hpp"
+#include "StateSnapshot.hpp"
+#include "BitRegister.hpp"
+#include "ValueRegister.hpp"
 
 using namespace c74::min;
 
-class LastNote {
+class ShiftRegisterMax : public object<ShiftRegisterMax> {
 private:
-    uint64_t pitch_ = 128;
-
-public:
-    bool dirty = false;
-
-    [[nodiscard]] auto get() const -> uint64_t { return this->pitch_; }
-
-    auto set(uint64_t noteValue) -> uint64_t {
-        this->pitch_ = noteValue;
-
-        if (!this->dirty) {
-            this->dirty = true;
-        }
+    InternalClock clock_ {this, [this] { return static_cast<double>(this->interval.get()); }, [this] {
+        this->step();
+        this->handleThrough();
+    }};
+    ClockFollower follower_ {this, [this] {
+        this->step();
+        this->handleThrough();
+    }};
 
-        return this->pitch_;
-    }
-};
-
-class ShiftRegisterMax : public object<ShiftRegisterMax> {
 public:
     MIN_DESCRIPTION{"Shift Register"}; // NOLINT 
     MIN_TAGS{"seidr"};                 // NOLINT 
@@ -43,24 +42,52 @@ public:
         BIT_COUNT = 8,
         OUTPUT_COUNT = 9,
         MAX_OUTPUTS = 32,
+        STATE_VERSION = 2
     };
 
     explicit ShiftRegisterMax(const atoms &args = {});
 
+    // Stops following before the timers go, the clock can wake it until then.
+    ~ShiftRegisterMax() { this->follower_.follow(""); }
+
+    ShiftRegisterMax(const ShiftRegisterMax &) = delete;
+    auto operator=(const ShiftRegisterMax &) -> ShiftRegisterMax & = delete;
+
     void handleOutputs();
     void handleThrough();
     auto size() -> int;
     auto step() -> int;
+    auto stepBy(int steps) -> int;
+    auto locateAt(int position) -> int;
+    auto followClock() -> int { return this->follower_.drain(); }
+    auto lastTick() const -> const Tick & { return this->follower_.lastTick(); }
+    auto pulse() -> void;
+    auto activate() -> void;
+    auto flush() -> void;
     auto get(int index) -> int;
     auto dataInput(int value) -> int;
     auto dataThrough() -> int;
+    auto setValueMode(bool enabled) -> void;
+    auto isValueMode() const -> bool { return this->valueMode_; }
+    // Any thread, the stages are resized on the scheduler before the next
+    // step, never while it steps them.
+    auto setLength(int length) -> void {
+        this->pendingLength_.store(std::clamp(length, 1, static_cast<int>(ValueRegister::MAX_LENGTH)), std::memory_order_relaxed);
+    }
+    auto memoryUsage() const -> size_t;
+    auto setBudget(int events, int microseconds) -> void;
+    auto shedCount() const -> uint64_t { return this->budget_.shedCount(); }
+
+    // State snapshots.
+    auto snapshot() -> std::vector<uint8_t>;
+    auto restore(StateReader &reader) -> bool;
+    auto recallSlot(int slot) -> bool;
 
     inlet<> input0{this, "(anything) input pulse"};
-    inlet<> input1{this, "(int|bang) input pulse"};
+    inlet<> input1{this, "(int|bang) data input, a bit or a value in value mode"};
     inlet<> input2{this, "(anything) input pulse"};
 
-    std::vector<std::unique_ptr<outlet<>>> outputs;
-    LastNote lastOutput[OUTPUT_COUNT] = {};
+    OutletArray<> outputs;
 
     c74::min::message<threadsafe::yes> anything{
         this, "anything", "Handle any message",
@@ -81,14 +108,12 @@ public:
         MIN_FUNCTION {
             switch (inlet) {
                 case 0: 
-                    sr_.step();
-                    handleThrough();
+                    this->pulse();
                     break;
                 case 1:
                     break;
                 case 2:
-                    sr_.activate();
-                    handleOutputs();
+                    this->activate();
                     break;
                 default:
                     break;
@@ -106,7 +131,7 @@ public:
                     // sr_.step();
                     // handleOutputs();
                     case 1: {
-                        this->sr_.dataInput(args[0]);
+                        this->dataInput(args[0]);
                         break;
                     }
                     default:
@@ -117,9 +142,183 @@ public:
         }
     };
 
+    c74::min::message<threadsafe::yes> step_msg{
+        this, "step", "step the shift register n times and output only the result",
+        MIN_FUNCTION {
+            if (!args.empty()) {
+                this->stepBy(args[0]);
+                this->handleThrough();
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> locate_msg{
+        this, "locate", "go to the state n steps after every stage was cleared, with the current data input",
+        MIN_FUNCTION {
+            if (!args.empty()) {
+                this->locateAt(args[0]);
+                this->handleThrough();
+            }
+            return {};
+        }
+    };
+
+    // Coalesced work, sent on the next tick.
+    c74::min::timer<> flush_tick {this,
+        MIN_FUNCTION{
+            this->flush();
+            return {};
+        }
+    };
+
+    c74::min::attribute<time_value> interval {this, "interval", 0.0,
+        description{"Step on an internal clock every interval, in ms or a note value. 0 turns the clock off."},
+        setter{
+            MIN_FUNCTION{
+                this->clock_.changed();
+                return args;
+            }
+        }
+    };
+
+    c74::min::attribute<c74::min::symbol> clock_name {this, "clock", "",
+        description{"Step on the ticks of the seidr.Clock~ with this name. Empty stops following."},
+        setter{
+            MIN_FUNCTION{
+                std::string name = args[0];
+
+                if (!this->follower_.follow(name)) {
+                    c74::max::object_error((c74::max::t_object*) this, "too many objects follow %s", name.c_str());
+                }
+                return args;
+            }
+        }
+    };
+
+    c74::min::message<threadsafe::yes> memory{
+        this, "memory", "post the number of bytes used by this instance",
+        MIN_FUNCTION {
+            c74::max::object_post((c74::max::t_object*) this, "%zu bytes", this->memoryUsage());
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> budget{
+        this, "budget", "pulses and microseconds per scheduler tick, pulses over it are merged into one step, no arguments turns it off",
+        MIN_FUNCTION {
+            int events = 0;
+            int microseconds = 0;
+
+            if (!MessageArgs::readOptionalInts(args, events, microseconds)) {
+                c74::max::object_error((c74::max::t_object*) this, "budget needs a number of pulses and microseconds");
+                return {};
+            }
+
+            this->setBudget(events, microseconds);
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> shed{
+        this, "shed", "post the number of pulses merged to stay in the budget",
+        MIN_FUNCTION {
+            c74::max::object_post((c74::max::t_object*) this, "%llu shed", static_cast<unsigned long long>(this->shedCount()));
+            return {};
+        }
+    };
+
+    c74::min::message<> store{
+        this, "store", "store the state in a slot (0-15)",
+        MIN_FUNCTION {
+            if (!args.empty()) {
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    c74::max::object_error((c74::max::t_object*) this, "store needs a slot number");
+                    return {};
+                }
+
+                this->slots_.store(slot, this->snapshot());
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> recall{
+        this, "recall", "recall the state stored in a slot (0-15)",
+        MIN_FUNCTION {
+            if (!args.empty()) {
+                int slot = 0;
+
+                if (!MessageArgs::readInt(args[0], slot)) {
+                    c74::max::object_error((c74::max::t_object*) this, "recall needs a slot number");
+                    return {};
+                }
+
+                this->recallSlot(slot);
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<> savestate{
+        this, "savestate", "save the state and the slots with the patcher",
+        MIN_FUNCTION {
+            dict state{args[0]};
+            StateSnapshot::save(state, this->snapshot(), this->slots_);
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> mode{
+        this, "mode", "bit or value, value mode holds a whole number in every stage",
+        MIN_FUNCTION {
+            if (!args.empty()) {
+                this->setValueMode(MessageArgs::isSymbol(args[0], MessageArgs::VALUE));
+            }
+            return {};
+        }
+    };
+
+    c74::min::message<threadsafe::yes> length{
+        this, "length", "number of stages in value mode",
+        MIN_FUNCTION {
+            if (!args.empty()) {
+                int stages = 0;
+
+                if (!MessageArgs::readInt(args[0], stages)) {
+                    c74::max::object_error((c74::max::t_object*) this, "length needs a number of stages");
+                    return {};
+                }
+
+                this->setLength(stages);
+            }
+            return {};
+        }
+    };
+
 private:
-    ShiftRegister sr_ = ShiftRegister(BIT_COUNT);
+    BitRegister sr_ = BitRegister(BIT_COUNT);
+    ValueRegister values_;
+
+    // A length set from the length message, 0 when there is none.
+    std::atomic<int> pendingLength_ {0};
+
+    auto applyLength() -> void;
+
+    // Last value sent from the data through output.
+    int lastThrough_ = -1;
+
+    StateSlots<> slots_;
+
+    // Overload protection, pulses over the budget are counted and stepped
+    // in one jump on the next tick.
+    EventBudget budget_;
+    std::atomic<uint32_t> pendingSteps_ {0};
+    std::atomic<bool> pendingOutputs_ {false};
+
+    bool valueMode_ = false;
     bool everyOutput = true;
     bool sendBangs = false;
-    int lastValue_ = 0;
 };
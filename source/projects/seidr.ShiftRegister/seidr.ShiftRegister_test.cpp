@@ -7,6 +7,9 @@
 #include "seidr.ShiftRegister.cpp" // NOLINT
 #include "seidr.ShiftRegister.hpp"
 #include <c74_min_unittest.h>
+#include "InstantiationBenchmark.hpp"
+#include "StressRunner.hpp"
+#include <iostream>
 
 using namespace c74::max;
 
@@ -42,3 +45,548 @@ SCENARIO("create an instance") { // NOLINT
     }
 }
 
+
+SCENARIO("value mode") { // NOLINT
+    ext_main(nullptr);
+
+    auto shiftRegister = ShiftRegisterMax();
+    shiftRegister.setValueMode(true);
+
+    REQUIRE(shiftRegister.isValueMode());
+    REQUIRE(shiftRegister.size() == ShiftRegisterMax::OUTPUT_COUNT - 1);
+
+    WHEN("notes are shifted in") {
+        for (int i = 0; i < shiftRegister.size(); i++) {
+            shiftRegister.dataInput(60 + i); // NOLINT
+            shiftRegister.step();
+        }
+
+        THEN("every stage holds a whole value") {
+            for (int i = 0; i < shiftRegister.size(); i++) {
+                REQUIRE(shiftRegister.get(i) == 60 + shiftRegister.size() - 1 - i); // NOLINT
+            }
+
+            REQUIRE(shiftRegister.dataThrough() == 0);
+        }
+
+        THEN("the first value falls out of the last stage") {
+            shiftRegister.dataInput(0);
+            REQUIRE(shiftRegister.step() == 60); // NOLINT
+            REQUIRE(shiftRegister.dataThrough() == 60); // NOLINT
+        }
+    }
+
+    WHEN("the register is long") {
+        shiftRegister.setLength(64); // NOLINT
+
+        for (int i = 0; i < 100; i++) { // NOLINT
+            shiftRegister.dataInput(i);
+            shiftRegister.step();
+        }
+
+        THEN("it works as a delay line") {
+            REQUIRE(shiftRegister.size() == 64);
+            REQUIRE(shiftRegister.get(0) == 99);
+            REQUIRE(shiftRegister.get(63) == 36);
+            REQUIRE(shiftRegister.dataThrough() == 35);
+        }
+    }
+
+    WHEN("the length is set between steps") {
+        int before = shiftRegister.size();
+        shiftRegister.setLength(16); // NOLINT
+
+        THEN("the stages are resized by the next step, not by the message") {
+            REQUIRE(shiftRegister.size() == before);
+            shiftRegister.step();
+            REQUIRE(shiftRegister.size() == 16);
+        }
+    }
+
+    WHEN("the length message gets something that isn't a number") {
+        int before = shiftRegister.size();
+        shiftRegister.length({ "long" });
+        shiftRegister.step();
+
+        THEN("it is rejected and the length is kept") {
+            REQUIRE(shiftRegister.size() == before);
+        }
+    }
+}
+
+SCENARIO("jump ahead") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("a register in value mode") {
+        auto stepped = ShiftRegisterMax();
+        auto jumped = ShiftRegisterMax();
+        stepped.setValueMode(true);
+        jumped.setValueMode(true);
+
+        for (int i = 0; i < 5; i++) { // NOLINT
+            stepped.dataInput(i + 1);
+            stepped.step();
+            jumped.dataInput(i + 1);
+            jumped.step();
+        }
+
+        WHEN("one is stepped three times and the other jumps three steps") {
+            stepped.dataInput(9); // NOLINT
+            jumped.dataInput(9); // NOLINT
+
+            for (int i = 0; i < 3; i++) { // NOLINT
+                stepped.step();
+            }
+
+            jumped.stepBy(3); // NOLINT
+
+            THEN("they hold the same values") {
+                for (int i = 0; i < jumped.size(); i++) {
+                    REQUIRE(jumped.get(i) == stepped.get(i));
+                }
+
+                REQUIRE(jumped.dataThrough() == stepped.dataThrough());
+            }
+        }
+
+        WHEN("it jumps further than its length") {
+            jumped.dataInput(9); // NOLINT
+            jumped.stepBy(1000); // NOLINT
+
+            THEN("every stage and the data through is the data input") {
+                for (int i = 0; i < jumped.size(); i++) {
+                    REQUIRE(jumped.get(i) == 9);
+                }
+
+                REQUIRE(jumped.dataThrough() == 9);
+            }
+        }
+    }
+
+    GIVEN("a register in bit mode") {
+        auto jumped = ShiftRegisterMax();
+
+        WHEN("one is stepped one by one and the other jumps the same number of steps") {
+            THEN("they hold the same bits and data through") {
+                for (int steps : {1, 3, 8, 9, 40}) { // NOLINT
+                    auto stepped = ShiftRegisterMax();
+                    auto other = ShiftRegisterMax();
+
+                    for (int bit : {1, 0, 1, 1, 0}) {
+                        stepped.dataInput(bit);
+                        stepped.step();
+                        other.dataInput(bit);
+                        other.step();
+                    }
+
+                    stepped.dataInput(1);
+                    other.dataInput(1);
+
+                    for (int i = 0; i < steps; i++) {
+                        stepped.step();
+                    }
+
+                    other.stepBy(steps);
+
+                    for (int i = 0; i < other.size(); i++) {
+                        REQUIRE(other.get(i) == stepped.get(i));
+                    }
+
+                    REQUIRE(other.dataThrough() == stepped.dataThrough());
+                }
+            }
+        }
+
+        WHEN("it is located") {
+            jumped.dataInput(1);
+            jumped.stepBy(40); // NOLINT
+            jumped.locateAt(3); // NOLINT
+
+            THEN("it holds the state three steps after a clear") {
+                for (int i = 0; i < jumped.size(); i++) {
+                    REQUIRE(jumped.get(i) == ((i < 3) ? 1 : 0));
+                }
+
+                REQUIRE(jumped.dataThrough() == 0);
+            }
+        }
+    }
+
+    GIVEN("a register in value mode that is located") {
+        auto located = ShiftRegisterMax();
+        located.setValueMode(true);
+        located.dataInput(4); // NOLINT
+        located.stepBy(20); // NOLINT
+        located.locate_msg({ 2 }, 0);
+
+        THEN("the first two stages hold the data input and the rest are cleared") {
+            REQUIRE(located.get(0) == 4);
+            REQUIRE(located.get(1) == 4);
+            REQUIRE(located.get(2) == 0);
+            REQUIRE(located.dataThrough() == 0);
+        }
+    }
+}
+
+SCENARIO("saving and recalling the register") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("a register with bits shifted in") {
+        auto shiftRegister = ShiftRegisterMax();
+        int bits[5] = { 1, 0, 1, 1, 0 }; // NOLINT
+
+        for (int bit : bits) {
+            shiftRegister.dataInput(bit);
+            shiftRegister.step();
+        }
+
+        shiftRegister.dataInput(1);
+
+        WHEN("a snapshot is restored into another register") {
+            auto other = ShiftRegisterMax();
+            auto snapshot = shiftRegister.snapshot();
+            StateReader reader(snapshot);
+
+            THEN("it holds the same bits and steps the same way") {
+                REQUIRE(other.restore(reader));
+
+                for (int i = 0; i < shiftRegister.size(); i++) {
+                    REQUIRE(other.get(i) == shiftRegister.get(i));
+                }
+
+                REQUIRE(other.step() == shiftRegister.step());
+
+                for (int i = 0; i < shiftRegister.size(); i++) {
+                    REQUIRE(other.get(i) == shiftRegister.get(i));
+                }
+            }
+        }
+
+        WHEN("a 1 has come through and the snapshot is restored into another register") {
+            shiftRegister.stepBy(shiftRegister.size() + 1);
+            REQUIRE(shiftRegister.dataThrough() == 1);
+
+            auto other = ShiftRegisterMax();
+            auto snapshot = shiftRegister.snapshot();
+            StateReader reader(snapshot);
+
+            THEN("the data through is restored as well") {
+                REQUIRE(other.restore(reader));
+                REQUIRE(other.dataThrough() == 1);
+            }
+        }
+    }
+
+    GIVEN("a snapshot of the first version, one byte for every bit stage") {
+        StateWriter writer(1);
+        uint8_t bits[3] = { 1, 0, 1 }; // NOLINT
+        int values[1] = {};
+
+        writer.write(false);
+        writer.write(true);
+        writer.write(false);
+        writer.writeArray(bits, 3);
+        writer.write(1);
+        writer.writeArray(values, 0);
+        writer.write(0);
+        writer.write(0);
+
+        WHEN("it is restored") {
+            auto shiftRegister = ShiftRegisterMax();
+            StateReader reader(writer.bytes());
+
+            THEN("the bits are back without being shifted in") {
+                REQUIRE(shiftRegister.restore(reader));
+                REQUIRE(shiftRegister.get(0) == 1);
+                REQUIRE(shiftRegister.get(1) == 0);
+                REQUIRE(shiftRegister.get(2) == 1);
+                REQUIRE(shiftRegister.get(3) == 0);
+                REQUIRE(shiftRegister.dataThrough() == 0);
+            }
+        }
+    }
+
+    GIVEN("a register in value mode") {
+        auto shiftRegister = ShiftRegisterMax();
+        shiftRegister.setValueMode(true);
+
+        for (int i = 0; i < 4; i++) { // NOLINT
+            shiftRegister.dataInput(60 + i); // NOLINT
+            shiftRegister.step();
+        }
+
+        WHEN("the state is stored, shifted on and recalled") {
+            std::vector<int> stored;
+
+            for (int i = 0; i < shiftRegister.size(); i++) {
+                stored.push_back(shiftRegister.get(i));
+            }
+
+            shiftRegister.store({ 4 }); // NOLINT
+            shiftRegister.dataInput(0);
+            shiftRegister.stepBy(3); // NOLINT
+            shiftRegister.setValueMode(false);
+            shiftRegister.recall({ 4 }); // NOLINT
+
+            THEN("the stages are back") {
+                REQUIRE(shiftRegister.isValueMode());
+
+                for (int i = 0; i < shiftRegister.size(); i++) {
+                    REQUIRE(shiftRegister.get(i) == stored[i]);
+                }
+            }
+        }
+
+        WHEN("an empty slot is recalled") {
+            THEN("nothing is restored") {
+                REQUIRE_FALSE(shiftRegister.recallSlot(9)); // NOLINT
+                REQUIRE(shiftRegister.isValueMode());
+            }
+        }
+    }
+}
+
+SCENARIO("keeping the register with the patcher") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("a register with a stored scene and a saved state dictionary") {
+        auto shiftRegister = ShiftRegisterMax();
+        c74::max::t_dictionary *dictionary = c74::max::dictionary_new();
+        c74::min::atom state(reinterpret_cast<c74::max::t_object *>(dictionary)); // NOLINT
+
+        shiftRegister.dataInput(1);
+        shiftRegister.stepBy(3); // NOLINT
+        shiftRegister.store({ 2 });
+        shiftRegister.dataInput(0);
+        shiftRegister.step();
+
+        shiftRegister.savestate({ state });
+
+        long count = 0;
+        c74::max::t_atom *values = nullptr;
+        REQUIRE(c74::max::dictionary_getatoms(dictionary, c74::max::gensym("seidr_state"), &count, &values) == 0);
+        auto size = static_cast<long>(c74::max::atom_getlong(values));
+
+        THEN("the bytes are packed four to an int atom after their count") {
+            REQUIRE(size > 0);
+            REQUIRE(count == 1 + ((size + 3) / 4));
+
+            auto word = static_cast<uint32_t>(c74::max::atom_getlong(values + 1));
+            REQUIRE(std::memcmp(&word, StateWriter::MAGIC.data(), StateWriter::MAGIC.size()) == 0);
+        }
+
+        THEN("another register loads the same state and scene") {
+            auto other = ShiftRegisterMax();
+            StateSlots<> slots;
+
+            REQUIRE(StateSnapshot::load(state, slots, [&other](StateReader &reader) { return other.restore(reader); }));
+
+            for (int i = 0; i < shiftRegister.size(); i++) {
+                REQUIRE(other.get(i) == shiftRegister.get(i));
+            }
+
+            REQUIRE(slots.recall(2, [&other](StateReader &reader) { return other.restore(reader); }));
+            REQUIRE(other.get(0) == 1);
+            REQUIRE(other.get(2) == 1);
+            REQUIRE(other.get(3) == 0);
+        }
+
+        THEN("a byte count that doesn't match the atoms is refused") {
+            std::vector<c74::max::t_atom> wrong(values, values + count);
+            c74::max::atom_setlong(wrong.data(), size + 8); // NOLINT
+            c74::max::dictionary_appendatoms(dictionary, c74::max::gensym("seidr_state"), static_cast<long>(wrong.size()), wrong.data());
+
+            auto other = ShiftRegisterMax();
+            StateSlots<> slots;
+
+            REQUIRE_FALSE(StateSnapshot::load(state, slots, [&other](StateReader &reader) { return other.restore(reader); }));
+        }
+
+        c74::max::object_free(dictionary);
+    }
+}
+
+SCENARIO("a scene is stored while it is recalled") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("a register stored in a slot") {
+        auto shiftRegister = ShiftRegisterMax();
+        auto other = ShiftRegisterMax();
+        StateSlots<> slots;
+
+        shiftRegister.dataInput(1);
+        shiftRegister.step();
+        REQUIRE(slots.store(0, shiftRegister.snapshot()));
+
+        WHEN("the slot is stored again in the middle of the recall") {
+            bool restored = slots.recall(0, [&](StateReader &reader) {
+                slots.store(0, std::vector<uint8_t>(3, 0)); // NOLINT
+                return other.restore(reader);
+            });
+
+            THEN("the recall still reads the snapshot it started with") {
+                REQUIRE(restored);
+                REQUIRE(other.get(0) == 1);
+                REQUIRE_FALSE(slots.recall(0, [&](StateReader &reader) { return other.restore(reader); }));
+            }
+        }
+    }
+}
+
+SCENARIO("pulses over the budget are merged") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("an event budget") {
+        EventBudget budget;
+        int runs = 0;
+
+        THEN("it lets everything through until it is set") {
+            for (int i = 0; i < 10; i++) { // NOLINT
+                REQUIRE(budget.run(0, [&] { runs++; }));
+            }
+
+            REQUIRE(runs == 10);
+        }
+
+        THEN("it only lets the budget through in each tick") {
+            budget.set(2, 0);
+
+            REQUIRE(budget.run(1, [&] { runs++; }));
+            REQUIRE(budget.run(1, [&] { runs++; }));
+            REQUIRE_FALSE(budget.run(1, [&] { runs++; }));
+            REQUIRE(budget.run(2, [&] { runs++; }));
+            REQUIRE(runs == 3);
+        }
+    }
+
+    GIVEN("two registers in value mode, one with a budget") {
+        auto stepped = ShiftRegisterMax();
+        auto budgeted = ShiftRegisterMax();
+        stepped.setValueMode(true);
+        budgeted.setValueMode(true);
+        budgeted.setBudget(2, 0);
+
+        WHEN("a burst of pulses arrives in one tick") {
+            for (int i = 0; i < 6; i++) { // NOLINT
+                stepped.dataInput(i + 1);
+                stepped.pulse();
+                budgeted.dataInput(i + 1);
+                budgeted.pulse();
+            }
+
+            THEN("the pulses over the budget are counted and stepped later in one jump") {
+                REQUIRE(stepped.shedCount() == 0);
+                REQUIRE(budgeted.shedCount() == 4);
+                REQUIRE(budgeted.get(0) == 2);
+
+                budgeted.flush();
+
+                // The jump shifts in the data input it finds, the last one.
+                int expected[6] = { 6, 6, 6, 6, 2, 1 }; // NOLINT
+
+                for (int i = 0; i < 6; i++) { // NOLINT
+                    REQUIRE(budgeted.get(i) == expected[i]);
+                }
+
+                REQUIRE(budgeted.get(5) == stepped.get(5)); // NOLINT
+            }
+        }
+    }
+}
+
+SCENARIO("following a seidr.Clock~") { // NOLINT
+    ext_main(nullptr);
+
+    GIVEN("a register in value mode following a clock") {
+        auto myObject = ShiftRegisterMax();
+        TickSender clock;
+
+        myObject.setValueMode(true);
+        myObject.dataInput(5); // NOLINT
+        REQUIRE(clock.setName("test.shiftregister"));
+        myObject.clock_name = "test.shiftregister";
+
+        WHEN("the clock ticks three times") {
+            for (uint32_t i = 0; i < 3; i++) {
+                clock.send(Tick {i * 64, i, 0}); // NOLINT
+            }
+
+            THEN("the register steps once for every tick") {
+                REQUIRE(myObject.followClock() == 3);
+
+                for (int i = 0; i < 3; i++) {
+                    REQUIRE(myObject.get(i) == 5);
+                }
+
+                REQUIRE(myObject.get(3) == 0);
+                REQUIRE(myObject.lastTick().index == 2);
+            }
+        }
+    }
+}
+
+SCENARIO("ShiftRegisterMax under concurrent messages", "[.stress]") { // NOLINT
+    ext_main(nullptr);
+
+    test_wrapper<ShiftRegisterMax> an_instance;
+    ShiftRegisterMax &shiftRegister = an_instance;
+
+    REQUIRE_NOTHROW(shiftRegister.mode({ "value" }));
+
+    // Every output is one of the values that were shifted in.
+    uint64_t sent = 0;
+    uint64_t invalid = 0;
+
+    auto drain = [&] {
+        for (int i = 0; i < ShiftRegisterMax::OUTPUT_COUNT; i++) {
+            auto &out = *object_getoutput(shiftRegister, i);
+
+            for (const auto &entry : out) {
+                int value = static_cast<int>(entry.back());
+                invalid += ((value >= 0) && (value < 128)) ? 0 : 1; // NOLINT
+            }
+
+            sent += out.size();
+            out.clear();
+        }
+    };
+
+    StressRunner stress(100000); // NOLINT
+
+    stress.scheduler("bang", [&](uint64_t) { shiftRegister.bang(); }, drain);
+
+    stress.main("data", [&](uint64_t n) {
+        shiftRegister.integer(static_cast<int>(n % 128), 1); // NOLINT
+    });
+
+    stress.main("length", [&](uint64_t n) {
+        shiftRegister.length(static_cast<int>(n % 64) + 1); // NOLINT
+    });
+
+    StressRunner::report("seidr.ShiftRegister", stress.run(), std::cout);
+
+    THEN("every output is a value that was shifted in and the state can be read") {
+        REQUIRE(sent > 0);
+        REQUIRE(invalid == 0);
+
+        std::vector<uint8_t> state = shiftRegister.snapshot();
+        StateReader reader(state);
+
+        REQUIRE(reader.isValid());
+        REQUIRE(shiftRegister.restore(reader));
+    }
+}
+
+SCENARIO("ShiftRegisterMax instantiation cost", "[.benchmark]") { // NOLINT
+    ext_main(nullptr);
+
+    auto result = InstantiationBenchmark::run<test_wrapper<ShiftRegisterMax>>(10000); // NOLINT
+    InstantiationBenchmark::report("seidr.ShiftRegister", result, std::cout);
+
+    THEN("every object was created and each one after the first costs the same") {
+        REQUIRE(result.count == 10000); // NOLINT
+        REQUIRE(result.lastAllocations > 0);
+        REQUIRE(result.lastAllocations < result.firstAllocations);
+        REQUIRE(result.allocations == Approx(result.lastAllocations).margin(0.01)); // NOLINT
+    }
+}
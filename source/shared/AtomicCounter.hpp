@@ -0,0 +1,153 @@
+/// @file       AtomicCounter.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+// A counter that counts from 0 to maxValue - 1 and wraps, with its whole
+// state in one 64-bit word.
+//
+// The value, the number of values, the preset and whether the counter has
+// been started since the last reset are packed together, so every operation
+// is a single atomic update of the word. Clock, reset, preset and max can come
+// from different threads without locks and a reader never sees a value from
+// one state and a max from another.
+//
+// The first tick after a reset only starts the counter, so the first output
+// after a reset is 0 and the counter steps from the second tick on.
+class AtomicCounter {
+public:
+    enum : uint32_t {
+        FIELD_BITS = 21,
+        LIMIT = (1U << FIELD_BITS) - 1 // NOLINT
+    };
+
+    struct State {
+        uint32_t value;
+        uint32_t maxValue;
+        uint32_t preset;
+        bool started;
+    };
+
+    explicit AtomicCounter(uint32_t maxValue = 8) // NOLINT
+        : word_(AtomicCounter::pack({0, AtomicCounter::clampMax(maxValue), 0, false})) {}
+
+    [[nodiscard]] auto load() const -> State { return AtomicCounter::unpack(this->word_.load(std::memory_order_acquire)); }
+    [[nodiscard]] auto value() const -> uint32_t { return this->load().value; }
+    [[nodiscard]] auto getMaxValue() const -> uint32_t { return this->load().maxValue; }
+    [[nodiscard]] auto isStarted() const -> bool { return this->load().started; }
+
+    // Step once, or start the counter on the first tick after a reset.
+    auto tick() -> uint32_t {
+        return this->update([](State &state) {
+            if (state.started) {
+                state.value = (state.value + 1) % state.maxValue;
+            }
+
+            state.started = true;
+        }).value;
+    }
+
+    // The result of n ticks in one update.
+    auto tick(uint32_t steps) -> uint32_t {
+        return this->update([steps](State &state) {
+            uint32_t count = steps;
+
+            if ((count > 0) && !state.started) {
+                state.started = true;
+                count--;
+            }
+
+            state.value = (state.value + (count % state.maxValue)) % state.maxValue;
+        }).value;
+    }
+
+    // Go to a position and start the counter there.
+    auto locate(uint32_t position) -> uint32_t {
+        return this->update([position](State &state) {
+            state.value = position % state.maxValue;
+            state.started = true;
+        }).value;
+    }
+
+    auto reset() -> void {
+        this->update([](State &state) {
+            state.value = 0;
+            state.started = false;
+        });
+    }
+
+    auto setPreset(uint32_t preset) -> uint32_t {
+        return this->update([preset](State &state) {
+            state.preset = std::min<uint32_t>(preset, LIMIT);
+        }).preset;
+    }
+
+    // Load the preset into the value.
+    auto preset() -> uint32_t {
+        return this->update([](State &state) {
+            state.value = state.preset % state.maxValue;
+        }).value;
+    }
+
+    // A value past the new max wraps.
+    auto setMaxValue(int maxValue) -> uint32_t {
+        uint32_t clamped = AtomicCounter::clampMax(maxValue);
+
+        return this->update([clamped](State &state) {
+            state.maxValue = clamped;
+            state.value %= clamped;
+        }).maxValue;
+    }
+
+    // Replace the whole state, from a snapshot.
+    auto restore(State state) -> void {
+        state.maxValue = AtomicCounter::clampMax(state.maxValue);
+        state.value %= state.maxValue;
+        state.preset = std::min<uint32_t>(state.preset, LIMIT);
+        this->word_.store(AtomicCounter::pack(state), std::memory_order_release);
+    }
+
+private:
+    static auto clampMax(int64_t maxValue) -> uint32_t {
+        return static_cast<uint32_t>(std::clamp<int64_t>(maxValue, 1, LIMIT));
+    }
+
+    static auto pack(const State &state) -> uint64_t {
+        return static_cast<uint64_t>(state.value) |
+               (static_cast<uint64_t>(state.maxValue) << FIELD_BITS) |
+               (static_cast<uint64_t>(state.preset) << (2 * FIELD_BITS)) |
+               (static_cast<uint64_t>(state.started) << (3 * FIELD_BITS));
+    }
+
+    static auto unpack(uint64_t word) -> State {
+        return {
+            static_cast<uint32_t>(word & LIMIT),
+            static_cast<uint32_t>((word >> FIELD_BITS) & LIMIT),
+            static_cast<uint32_t>((word >> (2 * FIELD_BITS)) & LIMIT),
+            ((word >> (3 * FIELD_BITS)) & 0x1) != 0
+        };
+    }
+
+    // Apply a change to the state with one compare and swap, returns the new
+    // state. Only retries when another thread changed the counter in between.
+    template <typename Change> auto update(Change change) -> State {
+        uint64_t expected = this->word_.load(std::memory_order_relaxed);
+        State state {};
+
+        do {
+            state = AtomicCounter::unpack(expected);
+            change(state);
+        } while (!this->word_.compare_exchange_weak(expected, AtomicCounter::pack(state), std::memory_order_acq_rel, std::memory_order_relaxed));
+
+        return state;
+    }
+
+    std::atomic<uint64_t> word_;
+};
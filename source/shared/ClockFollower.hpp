@@ -0,0 +1,47 @@
+/// @file       ClockFollower.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "TickChannel.hpp"
+#include <c74_min.h>
+#include <functional>
+#include <string>
+#include <utility>
+
+// Steps an object once for every tick from the seidr.Clock~ it follows.
+//
+// The first tick since the last drain wakes the follower from the audio
+// thread, and the ticks are drained in order on one of the object's timers,
+// on the scheduler. The object stops following in its destructor, before its
+// other members go, since the clock can wake it until then.
+class ClockFollower {
+public:
+    ClockFollower(c74::min::object_base *owner, std::function<void()> step)
+        : step_(std::move(step)), timer_(owner, MIN_FUNCTION {
+              this->drain();
+              return {};
+          }) {}
+
+    // Empty stops following. False when the channel has no room.
+    auto follow(const std::string &name) -> bool { return this->follower_.follow(name); }
+
+    // Steps once for every tick in the inbox, returns the number of steps.
+    auto drain() -> int {
+        return this->follower_.drain([this](const Tick &) {
+            this->step_();
+        });
+    }
+
+    [[nodiscard]] auto isFollowing() const -> bool { return this->follower_.isFollowing(); }
+    [[nodiscard]] auto lastTick() const -> const Tick & { return this->follower_.lastTick(); }
+    [[nodiscard]] auto dropped() const -> uint64_t { return this->follower_.dropped(); }
+
+private:
+    std::function<void()> step_;
+    c74::min::timer<> timer_;
+    TickFollower follower_ {[this] { this->timer_.delay(0); }};
+};
@@ -0,0 +1,52 @@
+/// @file       DriftFreeClock.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+// Tick times for an internal clock, in milliseconds of Max logical time.
+//
+// Every tick is scheduled from the time the previous tick was due, not from
+// when it fired, so late ticks don't push the following ones back and the
+// clock doesn't drift. If the clock falls more than a whole interval behind
+// it starts again from now instead of sending a burst of ticks.
+class DriftFreeClock {
+public:
+    auto start(double now) -> void {
+        this->last_ = now;
+        this->next_ = now;
+        this->running_ = true;
+    }
+
+    auto stop() -> void { this->running_ = false; }
+
+    // Move to the next tick, returns the delay from now until it is due.
+    auto advance(double now, double interval) -> double {
+        this->last_ = this->next_;
+        this->next_ += interval;
+
+        if (this->next_ <= now) {
+            this->next_ = now + interval;
+        }
+
+        return this->next_ - now;
+    }
+
+    // A new interval takes over from the last tick, the pending tick moves
+    // to one new interval after it. Returns the delay from now until it is
+    // due, 0 when that has already passed and the clock should tick now.
+    auto retime(double now, double interval) -> double {
+        this->next_ = this->last_ + interval;
+        return (this->next_ > now) ? this->next_ - now : 0.0;
+    }
+
+    [[nodiscard]] auto isRunning() const -> bool { return this->running_; }
+    [[nodiscard]] auto next() const -> double { return this->next_; }
+
+private:
+    double last_ = 0.0;
+    double next_ = 0.0;
+    bool running_ = false;
+};
@@ -0,0 +1,79 @@
+/// @file       DriftFreeClock_test.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "DriftFreeClock.hpp"
+#include <catch2/catch.hpp>
+
+SCENARIO("the internal clock does not drift") { // NOLINT
+    GIVEN("a clock started at 0 with an interval of 10 ms") {
+        DriftFreeClock clock;
+        clock.start(0.0);
+
+        REQUIRE(clock.isRunning());
+
+        WHEN("the ticks fire late") {
+            THEN("the next tick is still due on the grid") {
+                REQUIRE(clock.advance(3.0, 10.0) == Approx(7.0)); // NOLINT
+                REQUIRE(clock.advance(12.0, 10.0) == Approx(8.0)); // NOLINT
+                REQUIRE(clock.advance(21.0, 10.0) == Approx(9.0)); // NOLINT
+            }
+        }
+
+        WHEN("the clock falls more than an interval behind") {
+            clock.advance(0.0, 10.0); // NOLINT
+
+            THEN("it starts again from now") {
+                REQUIRE(clock.advance(45.0, 10.0) == Approx(10.0)); // NOLINT
+            }
+        }
+
+        WHEN("the clock is stopped") {
+            clock.stop();
+
+            THEN("it is not running") {
+                REQUIRE(!clock.isRunning());
+            }
+        }
+    }
+}
+
+SCENARIO("a new interval applies from the last tick") { // NOLINT
+    GIVEN("a clock that ticked at 0 and 100 with an interval of 100 ms") {
+        DriftFreeClock clock;
+        clock.start(0.0);
+        clock.advance(0.0, 100.0); // NOLINT
+        clock.advance(100.0, 100.0); // NOLINT
+
+        REQUIRE(clock.next() == Approx(200.0));
+
+        WHEN("the interval is shortened before the pending tick") {
+            double delay = clock.retime(120.0, 50.0); // NOLINT
+
+            THEN("the pending tick moves to one new interval after the last tick") {
+                REQUIRE(delay == Approx(30.0));
+                REQUIRE(clock.next() == Approx(150.0));
+            }
+
+            THEN("the ticks after it follow the new interval") {
+                REQUIRE(clock.advance(150.0, 50.0) == Approx(50.0)); // NOLINT
+                REQUIRE(clock.next() == Approx(200.0));
+            }
+        }
+
+        WHEN("the interval is lengthened") {
+            THEN("the pending tick moves later") {
+                REQUIRE(clock.retime(120.0, 400.0) == Approx(380.0)); // NOLINT
+            }
+        }
+
+        WHEN("the new interval has already passed since the last tick") {
+            THEN("the clock ticks now and keeps the grid of the last tick") {
+                REQUIRE(clock.retime(180.0, 50.0) == 0.0); // NOLINT
+                REQUIRE(clock.advance(180.0, 50.0) == Approx(20.0)); // NOLINT
+            }
+        }
+    }
+}
@@ -0,0 +1,90 @@
+/// @file       EventBudget.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <atomic>
+#include <c74_min.h>
+#include <chrono>
+#include <cstdint>
+
+// A limit on the work an object does in one scheduler tick.
+//
+// The budget is a number of events, a number of microseconds, or both, per
+// tick of the scheduler's logical time. Once a tick's budget is spent run()
+// refuses the work and the object coalesces it instead, stepping once for all
+// the steps it missed or sending only the last value, and counts the event
+// as shed. A burst then costs the object a bounded time per tick instead of
+// holding up the rest of the patch.
+//
+// The budget is off until set. The counters are relaxed atomics, events from
+// different threads in the same tick can go a little over the budget but
+// never corrupt it.
+class EventBudget {
+public:
+    // The scheduler's logical time in milliseconds, events with the same time
+    // are in the same tick.
+    static auto now() -> int64_t { return static_cast<int64_t>(c74::max::gettime()); }
+
+    // 0 is no limit, both 0 turns the budget off.
+    auto set(uint32_t events, uint32_t microseconds) -> void {
+        this->maxEvents_.store(events, std::memory_order_relaxed);
+        this->maxNanoseconds_.store(uint64_t {microseconds} * 1000, std::memory_order_relaxed); // NOLINT
+    }
+
+    [[nodiscard]] auto isEnabled() const -> bool {
+        return (this->maxEvents_.load(std::memory_order_relaxed) != 0) || (this->maxNanoseconds_.load(std::memory_order_relaxed) != 0);
+    }
+
+    // Run work for an event in the tick at logical time tick, false when the
+    // tick's budget is spent and work was not run.
+    template <typename Work> auto run(int64_t tick, Work work) -> bool {
+        uint32_t maxEvents = this->maxEvents_.load(std::memory_order_relaxed);
+        uint64_t maxNanoseconds = this->maxNanoseconds_.load(std::memory_order_relaxed);
+
+        if ((maxEvents == 0) && (maxNanoseconds == 0)) {
+            work();
+            return true;
+        }
+
+        if (this->tick_.exchange(tick, std::memory_order_relaxed) != tick) {
+            this->events_.store(0, std::memory_order_relaxed);
+            this->nanoseconds_.store(0, std::memory_order_relaxed);
+        }
+
+        if (((maxEvents != 0) && (this->events_.load(std::memory_order_relaxed) >= maxEvents)) ||
+            ((maxNanoseconds != 0) && (this->nanoseconds_.load(std::memory_order_relaxed) >= maxNanoseconds))) {
+            return false;
+        }
+
+        this->events_.fetch_add(1, std::memory_order_relaxed);
+
+        if (maxNanoseconds == 0) {
+            work();
+            return true;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        work();
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        this->nanoseconds_.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+        return true;
+    }
+
+    auto shed() -> void { this->shed_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Events coalesced or dropped since the object was created.
+    [[nodiscard]] auto shedCount() const -> uint64_t { return this->shed_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint32_t> maxEvents_ {0};
+    std::atomic<uint64_t> maxNanoseconds_ {0};
+
+    std::atomic<int64_t> tick_ {-1};
+    std::atomic<uint32_t> events_ {0};
+    std::atomic<uint64_t> nanoseconds_ {0};
+    std::atomic<uint64_t> shed_ {0};
+};
@@ -0,0 +1,94 @@
+/// @file       InstantiationBenchmark.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Heap allocations made by the program, counted by the replacement operator
+// new below. The replacement can only be defined once, so include this header
+// in one translation unit, the test file of a project.
+inline std::atomic<uint64_t> heapAllocations {0};
+
+auto operator new(std::size_t size) -> void * {
+    heapAllocations.fetch_add(1, std::memory_order_relaxed);
+
+    if (void *block = std::malloc((size == 0) ? 1 : size)) { // NOLINT
+        return block;
+    }
+
+    throw std::bad_alloc();
+}
+
+// Sanitizers replace the array forms separately, replace them here as well so
+// array allocations are counted in those builds too.
+auto operator new[](std::size_t size) -> void * { return ::operator new(size); }
+
+auto operator delete(void *block) noexcept -> void { std::free(block); }               // NOLINT
+auto operator delete(void *block, std::size_t) noexcept -> void { std::free(block); }   // NOLINT
+auto operator delete[](void *block) noexcept -> void { std::free(block); }             // NOLINT
+auto operator delete[](void *block, std::size_t) noexcept -> void { std::free(block); } // NOLINT
+
+// Creates many objects at once, like loading a large patch, and measures the
+// time and the heap allocations of each instantiation. The objects are all
+// alive at the end and only destroyed after the measurement.
+class InstantiationBenchmark {
+public:
+    struct Result {
+        int count = 0;
+        double microseconds = 0.0;
+        double allocations = 0.0;
+        uint64_t firstAllocations = 0; // Of the first object, which also sets up what its class shares.
+        uint64_t lastAllocations = 0;  // Of the last object, what every later instance costs.
+    };
+
+    template <typename Wrapper, typename... Args> static auto run(int count, const Args &...args) -> Result {
+        // Room for every object up front so only the objects allocate.
+        std::vector<std::optional<Wrapper>> objects(count);
+
+        Result result;
+        result.count = count;
+
+        uint64_t allocations = heapAllocations.load(std::memory_order_relaxed);
+        uint64_t before = allocations;
+        auto start = std::chrono::steady_clock::now();
+
+        for (auto &object : objects) {
+            uint64_t previous = heapAllocations.load(std::memory_order_relaxed);
+            object.emplace(args...);
+            result.lastAllocations = heapAllocations.load(std::memory_order_relaxed) - previous;
+
+            if (&object == &objects.front()) {
+                result.firstAllocations = result.lastAllocations;
+            }
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        allocations = heapAllocations.load(std::memory_order_relaxed) - before;
+
+        if (count > 0) {
+            result.microseconds = std::chrono::duration<double, std::micro>(elapsed).count() / count;
+            result.allocations = static_cast<double>(allocations) / count;
+        }
+
+        return result;
+    }
+
+    static auto report(const std::string &object, const Result &result, std::ostream &stream) -> void {
+        stream << object << " instantiation, " << result.count << " objects:\n"
+               << "  " << result.microseconds << " us per object\n"
+               << "  " << result.allocations << " allocations per object\n"
+               << "  " << result.firstAllocations << " allocations for the first object, " << result.lastAllocations << " for the last\n";
+    }
+};
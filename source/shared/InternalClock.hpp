@@ -0,0 +1,72 @@
+/// @file       InternalClock.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "DriftFreeClock.hpp"
+#include <atomic>
+#include <c74_min.h>
+#include <functional>
+#include <utility>
+
+// Steps an object every interval on one of its timers.
+//
+// The ticks are due on a DriftFreeClock grid in Max logical time, so they
+// stay in line with everything else the scheduler runs. The interval is read
+// from the object every tick, and a change is picked up right away instead
+// of after the pending tick.
+//
+// The interval attribute's setter calls changed(), so the clock has to be
+// declared before the attribute.
+class InternalClock {
+public:
+    InternalClock(c74::min::object_base *owner, std::function<double()> interval, std::function<void()> step)
+        : interval_(std::move(interval)), step_(std::move(step)), timer_(owner, MIN_FUNCTION {
+              this->fire();
+              return {};
+          }) {}
+
+    // Any thread, the interval has changed. The clock starts, stops or moves
+    // its pending tick on the scheduler.
+    auto changed() -> void {
+        this->retime_.store(true, std::memory_order_relaxed);
+        this->timer_.delay(0);
+    }
+
+    [[nodiscard]] auto isRunning() const -> bool { return this->clock_.isRunning(); }
+
+private:
+    auto fire() -> void {
+        double interval = this->interval_();
+        double now = c74::max::gettime();
+        bool retime = this->retime_.exchange(false, std::memory_order_relaxed);
+
+        if (interval <= 0.0) {
+            this->clock_.stop();
+            return;
+        }
+
+        if (!this->clock_.isRunning()) {
+            this->clock_.start(now);
+        } else if (retime) {
+            double delay = this->clock_.retime(now, interval);
+
+            if (delay > 0.0) {
+                this->timer_.delay(delay);
+                return;
+            }
+        }
+
+        this->step_();
+        this->timer_.delay(this->clock_.advance(now, interval));
+    }
+
+    DriftFreeClock clock_;
+    std::atomic<bool> retime_ {false};
+    std::function<double()> interval_;
+    std::function<void()> step_;
+    c74::min::timer<> timer_;
+};
@@ -0,0 +1,169 @@
+/// @file       MessageArgs.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "Utils/MIDI.hpp"
+#include <array>
+#include <c74_min.h>
+#include <charconv>
+#include <cstdint>
+#include <string_view>
+
+// Reading the arguments of seidr messages.
+//
+// Keywords are interned once and compared by symbol pointer, numbers are read
+// straight from the atom without going through a string, and nothing here
+// throws or allocates, so control messages can be sent at note rate from the
+// scheduler thread. A malformed argument only makes a read return false.
+class MessageArgs {
+public:
+    // Keywords of the seidr messages.
+    static inline const c74::min::symbol ALL {"all"};
+    static inline const c74::min::symbol PATTERN {"pattern"};
+    static inline const c74::min::symbol VALUE {"value"};
+
+    static auto isSymbol(const c74::min::atom &arg, const c74::min::symbol &keyword) -> bool {
+        return (arg.a_type == c74::max::A_SYM) && (arg.a_w.w_sym == static_cast<c74::max::t_symbol *>(keyword));
+    }
+
+    // An int or a float, floats are truncated. A symbol is read when it is a
+    // whole number, like the ones that come out of tosymbol.
+    static auto readInt(const c74::min::atom &arg, int &result) -> bool {
+        switch (arg.a_type) {
+        case c74::max::A_LONG:
+            result = static_cast<int>(arg.a_w.w_long);
+            return true;
+        case c74::max::A_FLOAT:
+            result = static_cast<int>(arg.a_w.w_float);
+            return true;
+        case c74::max::A_SYM:
+            return MessageArgs::parseInt(arg.a_w.w_sym->s_name, result);
+        default:
+            return false;
+        }
+    }
+
+    // The leading arguments as ints, false when there are fewer arguments
+    // than ints or one of them isn't a number.
+    template <typename... Ints> static auto readInts(const c74::min::atoms &args, Ints &...results) -> bool {
+        if (args.size() < sizeof...(Ints)) {
+            return false;
+        }
+
+        size_t index = 0;
+        return (MessageArgs::readInt(args[index++], results) && ...);
+    }
+
+    // The same for arguments that can be left out, the ints of missing ones
+    // keep their value.
+    template <typename... Ints> static auto readOptionalInts(const c74::min::atoms &args, Ints &...results) -> bool {
+        size_t index = 0;
+        bool valid = true;
+        ((valid = valid && ((index >= args.size()) || MessageArgs::readInt(args[index], results)), index++), ...);
+        return valid;
+    }
+
+    // A MIDI note number, or a note name like C4, F#2 or Bb-1.
+    static auto readNote(const c74::min::atom &arg, int &note) -> bool {
+        int value = 0;
+
+        if ((arg.a_type == c74::max::A_SYM) && MessageArgs::parseNoteName(arg.a_w.w_sym->s_name, value)) {
+            note = value;
+            return true;
+        }
+
+        if (MessageArgs::readInt(arg, value) && (value >= MIDI::RANGE_LOW) && (value <= MIDI::RANGE_HIGH)) {
+            note = value;
+            return true;
+        }
+
+        return false;
+    }
+
+    static auto parseInt(std::string_view text, int &result) -> bool {
+        int value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+
+        if ((error != std::errc()) || (end != text.data() + text.size()) || text.empty()) {
+            return false;
+        }
+
+        result = value;
+        return true;
+    }
+
+    // Scientific pitch notation, C4 is 60. The letter is not case sensitive,
+    // # is a sharp and b a flat.
+    static constexpr auto parseNoteName(std::string_view name, int &note) -> bool {
+        if (name.size() < 2) {
+            return false;
+        }
+
+        char letter = name[0];
+        letter = ((letter >= 'a') && (letter <= 'z')) ? static_cast<char>(letter - 'a' + 'A') : letter;
+
+        if ((letter < 'A') || (letter > 'G')) {
+            return false;
+        }
+
+        size_t at = 1;
+        int accidental = 0;
+
+        if (name[at] == '#') {
+            accidental = 1;
+            at++;
+        } else if (name[at] == 'b') {
+            accidental = 2;
+            at++;
+        }
+
+        int octave = 0;
+
+        if (!MessageArgs::parseOctave(name.substr(at), octave)) {
+            return false;
+        }
+
+        int value = ((octave + 1) * MIDI::OCTAVE) + PITCH_CLASSES[((letter - 'A') * 3) + accidental]; // NOLINT
+
+        if ((value < MIDI::RANGE_LOW) || (value > MIDI::RANGE_HIGH)) {
+            return false;
+        }
+
+        note = value;
+        return true;
+    }
+
+private:
+    // Semitones from C for every spelling of a note, indexed by letter and
+    // accidental (none, #, b). Every spelling has its own slot, so the table is
+    // a perfect hash of the 21 names and a lookup is one index.
+    static constexpr std::array<int8_t, 21> PITCH_CLASSES = [] { // NOLINT
+        constexpr std::array<int8_t, 7> NATURALS = {9, 11, 0, 2, 4, 5, 7}; // NOLINT A B C D E F G
+        std::array<int8_t, 21> table = {};                                // NOLINT
+
+        for (size_t letter = 0; letter < NATURALS.size(); letter++) {
+            table[(letter * 3) + 0] = NATURALS[letter];
+            table[(letter * 3) + 1] = static_cast<int8_t>(NATURALS[letter] + 1);
+            table[(letter * 3) + 2] = static_cast<int8_t>(NATURALS[letter] - 1);
+        }
+
+        return table;
+    }();
+
+    // -1 to 9.
+    static constexpr auto parseOctave(std::string_view text, int &octave) -> bool {
+        bool negative = !text.empty() && (text[0] == '-');
+        text.remove_prefix(negative ? 1 : 0);
+
+        if ((text.size() != 1) || (text[0] < '0') || (text[0] > '9')) {
+            return false;
+        }
+
+        octave = negative ? -(text[0] - '0') : (text[0] - '0');
+        return octave >= -1;
+    }
+};
@@ -0,0 +1,377 @@
+/// @file       MessageLog.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Binary log of the messages an object receives.
+//
+// Records are encoded into a scratch block and copied into a ring buffer,
+// both allocated when the log is opened so an object that doesn't record
+// only pays for a few words. The calling thread never allocates, locks or
+// touches the disk. A background thread drains the ring to the file every few
+// milliseconds. When the ring is full the record is dropped and counted
+// instead of blocking the caller.
+//
+// The ring has a single consumer, the flush thread. Max can deliver messages
+// on both the main and the scheduler thread, so a writer holds a flag from
+// begin() to commit(). A writer that finds the flag taken doesn't wait for
+// it, its record is dropped and counted like one that doesn't fit the ring.
+// close() takes the flag before the last drain, so no record can land after
+// it, and begin() checks that the log is open while it holds the flag, which
+// also makes the start time written by open() visible to it.
+//
+// File layout, numbers in host byte order:
+//   header  "SEIDRLOG" uint32 version
+//   record  uint16 size, then size bytes:
+//           float64 time (ms since the log was opened), uint8 inlet,
+//           uint8 length, selector, uint8 count, count values
+//   value   'i' int64 | 'f' float64 | 's' uint8 length, symbol
+class MessageLog {
+public:
+    enum : uint32_t {
+        VERSION = 1,
+        RING_SIZE = 1U << 16U,  // NOLINT
+        RECORD_SIZE = 1024      // NOLINT
+    };
+
+    static constexpr std::array<char, 8> MAGIC = {'S', 'E', 'I', 'D', 'R', 'L', 'O', 'G'};
+
+    struct Value {
+        char type = 'i';
+        int64_t integer = 0;
+        double number = 0.0;
+        std::string symbol;
+    };
+
+    struct Record {
+        double time = 0.0;
+        int inlet = 0;
+        std::string selector;
+        std::vector<Value> values;
+    };
+
+    MessageLog() = default;
+    ~MessageLog() { this->close(); }
+
+    MessageLog(const MessageLog &) = delete;
+    auto operator=(const MessageLog &) -> MessageLog & = delete;
+
+    auto open(const std::string &path) -> bool {
+        this->close();
+
+        this->file_ = std::fopen(path.c_str(), "wb");
+
+        if (this->file_ == nullptr) {
+            return false;
+        }
+
+        // The ring and the scratch block behind it are only allocated for
+        // objects that record.
+        this->ring_.resize(RING_SIZE + RECORD_SIZE);
+
+        uint32_t version = VERSION;
+        std::fwrite(MAGIC.data(), 1, MAGIC.size(), this->file_);
+        std::fwrite(&version, sizeof(version), 1, this->file_);
+
+        this->start_ = MessageLog::now();
+        this->dropped_.store(0, std::memory_order_relaxed);
+        this->running_.store(true, std::memory_order_release);
+        this->flushThread_ = std::thread([this] { this->flushLoop(); });
+        this->recording_.store(true, std::memory_order_release);
+        return true;
+    }
+
+    auto close() -> void {
+        if (!this->recording_.exchange(false, std::memory_order_acq_rel)) {
+            return;
+        }
+
+        // Wait for a writer that got in before recording stopped, close()
+        // runs on the main thread and a record takes microseconds.
+        while (this->writing_.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+
+        this->running_.store(false, std::memory_order_release);
+        this->flushThread_.join();
+        this->drain();
+        std::fclose(this->file_);
+        this->file_ = nullptr;
+
+        this->writing_.clear(std::memory_order_release);
+    }
+
+    [[nodiscard]] auto isRecording() const -> bool { return this->recording_.load(std::memory_order_relaxed); }
+    [[nodiscard]] auto dropped() const -> uint32_t { return this->dropped_.load(std::memory_order_relaxed); }
+
+    // Heap bytes of the ring and the scratch block, 0 until the log is
+    // opened.
+    [[nodiscard]] auto bytes() const -> size_t { return this->ring_.capacity(); }
+
+    // Writing a record, begin() returns false when nothing is recorded and the
+    // values and commit() are skipped.
+    auto begin(int inlet, const char *selector) -> bool {
+        if (!this->isRecording()) {
+            return false;
+        }
+
+        if (this->writing_.test_and_set(std::memory_order_acquire)) {
+            this->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (!this->recording_.load(std::memory_order_acquire)) {
+            this->writing_.clear(std::memory_order_release);
+            return false;
+        }
+
+        this->size_ = sizeof(uint16_t);
+        this->count_ = 0;
+        this->overflow_ = false;
+
+        this->put(MessageLog::now() - this->start_);
+        this->put(static_cast<uint8_t>(inlet));
+        this->putString(selector);
+        this->countAt_ = this->size_;
+        this->put(static_cast<uint8_t>(0));
+        return true;
+    }
+
+    auto addInt(int64_t value) -> void {
+        this->putType('i');
+        this->put(value);
+        this->count_++;
+    }
+
+    auto addFloat(double value) -> void {
+        this->putType('f');
+        this->put(value);
+        this->count_++;
+    }
+
+    auto addSymbol(const char *value) -> void {
+        this->putType('s');
+        this->putString(value);
+        this->count_++;
+    }
+
+    auto commit() -> void {
+        if (this->overflow_) {
+            this->dropped_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            auto body = static_cast<uint16_t>(this->size_ - sizeof(uint16_t));
+            std::memcpy(this->scratch(), &body, sizeof(body));
+            this->scratch()[this->countAt_] = this->count_;
+            this->push(this->scratch(), this->size_);
+        }
+
+        this->writing_.clear(std::memory_order_release);
+    }
+
+    // Reading a log back.
+    class Reader {
+    public:
+        explicit Reader(const std::string &path) : file_(std::fopen(path.c_str(), "rb")) {
+            std::array<char, 8> magic = {};
+            uint32_t version = 0;
+
+            this->valid_ = (this->file_ != nullptr) &&
+                           (std::fread(magic.data(), 1, magic.size(), this->file_) == magic.size()) &&
+                           (std::fread(&version, sizeof(version), 1, this->file_) == 1) &&
+                           (magic == MAGIC) && (version == VERSION);
+        }
+
+        ~Reader() {
+            if (this->file_ != nullptr) {
+                std::fclose(this->file_);
+            }
+        }
+
+        Reader(const Reader &) = delete;
+        auto operator=(const Reader &) -> Reader & = delete;
+
+        [[nodiscard]] auto isValid() const -> bool { return this->valid_; }
+
+        auto next(Record &record) -> bool {
+            uint16_t size = 0;
+
+            if (!this->valid_ || (std::fread(&size, sizeof(size), 1, this->file_) != 1)) {
+                return false;
+            }
+
+            this->buffer_.resize(size);
+
+            if (std::fread(this->buffer_.data(), 1, size, this->file_) != size) {
+                return false;
+            }
+
+            this->at_ = 0;
+            record.time = this->get<double>();
+            record.inlet = this->get<uint8_t>();
+            record.selector = this->getString();
+            record.values.resize(this->get<uint8_t>());
+
+            for (auto &value : record.values) {
+                value.type = this->get<char>();
+
+                if (value.type == 'i') {
+                    value.integer = this->get<int64_t>();
+                } else if (value.type == 'f') {
+                    value.number = this->get<double>();
+                } else {
+                    value.symbol = this->getString();
+                }
+            }
+
+            return this->at_ <= this->buffer_.size();
+        }
+
+    private:
+        template <typename T> auto get() -> T {
+            T value {};
+
+            if (this->at_ + sizeof(T) <= this->buffer_.size()) {
+                std::memcpy(&value, this->buffer_.data() + this->at_, sizeof(T));
+            }
+
+            this->at_ += sizeof(T);
+            return value;
+        }
+
+        auto getString() -> std::string {
+            size_t length = this->get<uint8_t>();
+            std::string value;
+
+            if (this->at_ + length <= this->buffer_.size()) {
+                value.assign(reinterpret_cast<const char *>(this->buffer_.data() + this->at_), length); // NOLINT
+            }
+
+            this->at_ += length;
+            return value;
+        }
+
+        std::FILE *file_;
+        bool valid_ = false;
+        std::vector<uint8_t> buffer_;
+        size_t at_ = 0;
+    };
+
+private:
+    static auto now() -> double {
+        auto elapsed = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration<double, std::milli>(elapsed).count();
+    }
+
+    auto scratch() -> uint8_t * { return this->ring_.data() + RING_SIZE; }
+
+    template <typename T> auto put(T value) -> void {
+        if (this->size_ + sizeof(T) > RECORD_SIZE) {
+            this->overflow_ = true;
+            return;
+        }
+
+        std::memcpy(this->scratch() + this->size_, &value, sizeof(T));
+        this->size_ += sizeof(T);
+    }
+
+    auto putType(char type) -> void {
+        if (this->count_ == UINT8_MAX) {
+            this->overflow_ = true;
+        }
+
+        this->put(type);
+    }
+
+    auto putString(const char *value) -> void {
+        size_t length = std::min<size_t>(std::strlen(value), UINT8_MAX);
+
+        this->put(static_cast<uint8_t>(length));
+
+        if (this->size_ + length > RECORD_SIZE) {
+            this->overflow_ = true;
+            return;
+        }
+
+        std::memcpy(this->scratch() + this->size_, value, length);
+        this->size_ += length;
+    }
+
+    // Producer side of the ring.
+    auto push(const uint8_t *data, size_t size) -> void {
+        size_t head = this->head_.load(std::memory_order_relaxed);
+        size_t tail = this->tail_.load(std::memory_order_acquire);
+
+        if (size > RING_SIZE - (head - tail)) {
+            this->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        size_t at = head & (RING_SIZE - 1);
+        size_t first = std::min<size_t>(size, RING_SIZE - at);
+
+        std::memcpy(this->ring_.data() + at, data, first);
+        std::memcpy(this->ring_.data(), data + first, size - first);
+        this->head_.store(head + size, std::memory_order_release);
+    }
+
+    // Consumer side of the ring, only called from the flush thread or after
+    // it has stopped.
+    auto drain() -> void {
+        size_t tail = this->tail_.load(std::memory_order_relaxed);
+        size_t head = this->head_.load(std::memory_order_acquire);
+
+        if (head == tail) {
+            return;
+        }
+
+        size_t at = tail & (RING_SIZE - 1);
+        size_t size = head - tail;
+        size_t first = std::min<size_t>(size, RING_SIZE - at);
+
+        std::fwrite(this->ring_.data() + at, 1, first, this->file_);
+        std::fwrite(this->ring_.data(), 1, size - first, this->file_);
+        this->tail_.store(head, std::memory_order_release);
+    }
+
+    auto flushLoop() -> void {
+        while (this->running_.load(std::memory_order_acquire)) {
+            this->drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10)); // NOLINT
+        }
+    }
+
+    // Ring, written by callers and read by the flush thread, followed by the
+    // scratch block of the record being written. The indices are on their
+    // own cache lines so the writer and the flush thread don't share one.
+    std::vector<uint8_t> ring_;
+    alignas(64) std::atomic<size_t> head_ {0}; // NOLINT
+    alignas(64) std::atomic<size_t> tail_ {0}; // NOLINT
+    std::atomic_flag writing_ = ATOMIC_FLAG_INIT;
+
+    // Record being written.
+    size_t size_ = 0;
+    size_t countAt_ = 0;
+    uint8_t count_ = 0;
+    bool overflow_ = false;
+
+    std::atomic<bool> recording_ {false};
+    std::atomic<bool> running_ {false};
+    std::atomic<uint32_t> dropped_ {0};
+    std::thread flushThread_;
+    std::FILE *file_ = nullptr;
+    double start_ = 0.0;
+};
@@ -0,0 +1,62 @@
+/// @file       MessageLog_test.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#include "MessageLog.hpp"
+#include <catch2/catch.hpp>
+#include <filesystem>
+
+namespace {
+    auto countRecords(const std::string &path) -> int {
+        MessageLog::Reader reader(path);
+        MessageLog::Record record;
+        int count = 0;
+
+        while (reader.next(record)) {
+            count++;
+        }
+
+        return count;
+    }
+} // namespace
+
+SCENARIO("writers never wait for each other") { // NOLINT
+    std::string path = (std::filesystem::temp_directory_path() / "seidr.MessageLog_test.log").string();
+
+    GIVEN("an open log") {
+        MessageLog log;
+        REQUIRE(log.open(path));
+
+        WHEN("a message arrives while another one is being written") {
+            REQUIRE(log.begin(0, "int"));
+            log.addInt(60); // NOLINT
+
+            bool second = log.begin(1, "float");
+            log.commit();
+            log.close();
+
+            THEN("the second message is dropped and counted instead of waiting") {
+                REQUIRE_FALSE(second);
+                REQUIRE(log.dropped() == 1);
+                REQUIRE(countRecords(path) == 1);
+            }
+        }
+
+        WHEN("the log is closed") {
+            REQUIRE(log.begin(0, "int"));
+            log.addInt(60); // NOLINT
+            log.commit();
+            log.close();
+
+            THEN("later messages are not written anywhere") {
+                REQUIRE_FALSE(log.isRecording());
+                REQUIRE_FALSE(log.begin(0, "int"));
+                REQUIRE(countRecords(path) == 1);
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
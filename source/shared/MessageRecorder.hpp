@@ -0,0 +1,87 @@
+/// @file       MessageRecorder.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "MessageLog.hpp"
+#include <c74_min.h>
+#include <string>
+
+// Records the messages an object receives into a MessageLog and plays a log
+// back into an object, by selector, through its message table. Playback
+// ignores the timestamps and sends the messages as fast as possible, which is
+// what profiling and the test wrapper want.
+//
+// seidr.quantizer and seidr.randomoctave have a record message, the other
+// objects don't record yet.
+class MessageRecorder {
+public:
+    auto open(const std::string &path) -> bool { return this->log_.open(path); }
+    auto close() -> void { this->log_.close(); }
+
+    [[nodiscard]] auto isRecording() const -> bool { return this->log_.isRecording(); }
+    [[nodiscard]] auto dropped() const -> uint32_t { return this->log_.dropped(); }
+    [[nodiscard]] auto bytes() const -> size_t { return this->log_.bytes(); }
+
+    auto record(int inlet, const char *selector, const c74::min::atoms &args) -> void {
+        if (!this->log_.begin(inlet, selector)) {
+            return;
+        }
+
+        for (const auto &arg : args) {
+            if (arg.type() == c74::min::message_type::float_argument) {
+                this->log_.addFloat(static_cast<double>(arg));
+            } else if (arg.type() == c74::min::message_type::symbol_argument) {
+                this->log_.addSymbol(static_cast<c74::min::symbol>(arg).c_str());
+            } else {
+                this->log_.addInt(static_cast<long>(arg));
+            }
+        }
+
+        this->log_.commit();
+    }
+
+    // Returns the number of messages sent, or -1 if the log can't be read.
+    template <typename Object> static auto replay(Object &object, const std::string &path) -> int {
+        MessageLog::Reader reader(path);
+
+        if (!reader.isValid()) {
+            return -1;
+        }
+
+        MessageLog::Record record;
+        c74::min::atoms args;
+        int count = 0;
+
+        while (reader.next(record)) {
+            auto message = object.messages().find(record.selector);
+
+            if (message == object.messages().end()) {
+                continue;
+            }
+
+            args.clear();
+
+            for (const auto &value : record.values) {
+                if (value.type == 'i') {
+                    args.emplace_back(static_cast<long>(value.integer));
+                } else if (value.type == 'f') {
+                    args.emplace_back(value.number);
+                } else {
+                    args.emplace_back(c74::min::symbol(value.symbol));
+                }
+            }
+
+            (*message->second)(args, record.inlet);
+            count++;
+        }
+
+        return count;
+    }
+
+private:
+    MessageLog log_;
+};
@@ -0,0 +1,108 @@
+/// @file       MidiParser.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Incremental parser for a raw MIDI byte stream, as sent by midiin.
+//
+// Bytes are fed one at a time and a message is returned once all of its data
+// bytes have arrived. Running status is supported: data bytes without a new
+// status byte reuse the last channel status. Real-time bytes can appear
+// anywhere and are returned on their own without disturbing the message in
+// progress. System exclusive and other system common messages are skipped.
+class MidiParser {
+public:
+    enum : uint8_t {
+        NOTE_OFF = 0x80,
+        NOTE_ON = 0x90,
+        POLY_PRESSURE = 0xA0,
+        CONTROL_CHANGE = 0xB0,
+        PROGRAM_CHANGE = 0xC0,
+        CHANNEL_PRESSURE = 0xD0,
+        PITCH_BEND = 0xE0,
+        SYSTEM = 0xF0,
+        SYSEX_END = 0xF7,
+        REAL_TIME = 0xF8
+    };
+
+    struct Message {
+        uint8_t status = 0;
+        uint8_t data1 = 0;
+        uint8_t data2 = 0;
+        uint8_t size = 0;
+
+        [[nodiscard]] auto type() const -> uint8_t { return this->status & 0xF0; } // NOLINT
+        [[nodiscard]] auto channel() const -> int { return this->status & 0x0F; }  // NOLINT
+
+        // Note on with velocity 0 is a note off.
+        [[nodiscard]] auto isNote() const -> bool {
+            return (this->type() == NOTE_ON) || (this->type() == NOTE_OFF);
+        }
+
+        [[nodiscard]] auto velocity() const -> int {
+            return (this->type() == NOTE_ON) ? this->data2 : 0;
+        }
+    };
+
+    // Feed one byte, returns true when it completes a message.
+    auto parse(int byte, Message &message) -> bool {
+        auto value = static_cast<uint8_t>(byte);
+
+        if (value >= REAL_TIME) {
+            message = {value, 0, 0, 1};
+            return true;
+        }
+
+        if (value >= SYSTEM) {
+            // Only channel messages are parsed, system common messages
+            // cancel running status until the next status byte.
+            this->status_ = 0;
+            this->count_ = 0;
+            return false;
+        }
+
+        if (value & 0x80) { // NOLINT
+            this->status_ = value;
+            this->count_ = 0;
+            return false;
+        }
+
+        // Data bytes without a status are dropped.
+        if (this->status_ == 0) {
+            return false;
+        }
+
+        this->data_[this->count_++] = value;
+
+        if (this->count_ < MidiParser::dataSize(this->status_)) {
+            return false;
+        }
+
+        message = {this->status_, this->data_[0], this->data_[1], static_cast<uint8_t>(this->count_ + 1)};
+        this->data_ = {};
+        this->count_ = 0;
+        return true;
+    }
+
+    auto reset() -> void {
+        this->status_ = 0;
+        this->count_ = 0;
+    }
+
+    // Number of data bytes that follow a channel status byte.
+    static auto dataSize(uint8_t status) -> uint8_t {
+        uint8_t type = status & 0xF0; // NOLINT
+        return ((type == PROGRAM_CHANGE) || (type == CHANNEL_PRESSURE)) ? 1 : 2;
+    }
+
+private:
+    uint8_t status_ = 0;
+    uint8_t count_ = 0;
+    std::array<uint8_t, 2> data_ = {};
+};
@@ -0,0 +1,250 @@
+/// @file       NoteIndex.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "Utils/MIDI.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The notes that were sent for every input pitch.
+//
+// Each voice keeps the MIDI channel it was played on, so its note off goes
+// out on the same channel, and a note off only releases the voices of its
+// own channel.
+//
+// Notes live in a fixed array of voices. Each input pitch has a short list
+// of its voices for retriggers of the same key, and all voices are kept in
+// the order they were started, so adding, releasing and stealing the
+// oldest voice never searches through the other keys.
+class NoteIndex {
+public:
+    enum : uint8_t {
+        SLOTS = 4,
+        VOICES = 128,
+        ANY_CHANNEL = 0xFF
+    };
+
+    struct Note {
+        uint8_t input;
+        uint8_t pitch;
+        uint8_t velocity;
+        int16_t voice;
+        uint8_t channel;
+    };
+
+    struct Entry {
+        uint8_t count;
+        uint8_t pitch[SLOTS];
+        uint8_t velocity[SLOTS];
+        int16_t voice[SLOTS];
+        uint8_t channel[SLOTS];
+        bool stolen; // A voice of the input was stolen since it was pressed.
+    };
+
+    NoteIndex() { this->clear(); }
+
+    // Add a note sent for an input pitch. When all of the input's slots or
+    // all of the voices are in use the oldest note is dropped and written to
+    // evicted.
+    auto add(int input, int pitch, int velocity, Note &evicted, int channel = 0) -> bool {
+        bool stolen = false;
+
+        if (this->counts_[input] == SLOTS) {
+            stolen = this->remove(this->keyHead_[input], evicted);
+        } else if (this->size_ >= this->polyphony_) {
+            stolen = this->steal(evicted);
+        }
+
+        int16_t voice = this->free_;
+        Voice &slot = this->voices_[voice];
+        this->free_ = slot.next;
+
+        slot.note = {static_cast<uint8_t>(input), static_cast<uint8_t>(pitch), static_cast<uint8_t>(velocity), voice, static_cast<uint8_t>(channel)};
+
+        // Append to the key.
+        slot.key = NONE;
+
+        if (this->keyTail_[input] == NONE) {
+            this->keyHead_[input] = voice;
+        } else {
+            this->voices_[this->keyTail_[input]].key = voice;
+        }
+
+        this->keyTail_[input] = voice;
+        this->counts_[input]++;
+
+        // Append to the age list.
+        slot.prev = this->newest_;
+        slot.next = NONE;
+
+        if (this->newest_ == NONE) {
+            this->oldest_ = voice;
+        } else {
+            this->voices_[this->newest_].next = voice;
+        }
+
+        this->newest_ = voice;
+        slot.active = true;
+        this->size_++;
+
+        return stolen;
+    }
+
+    // Remove and return everything that was sent for an input pitch on a
+    // channel, or on every channel.
+    auto release(int input, int channel = ANY_CHANNEL) -> Entry {
+        Entry entry = {};
+        Note note = {};
+
+        entry.stolen = this->stolen_[input];
+        this->stolen_[input] = false;
+
+        int16_t voice = this->keyHead_[input];
+
+        while (voice != NONE) {
+            int16_t next = this->voices_[voice].key;
+
+            if (((channel == ANY_CHANNEL) || (this->voices_[voice].note.channel == channel)) && this->remove(voice, note)) {
+                entry.pitch[entry.count] = note.pitch;
+                entry.velocity[entry.count] = note.velocity;
+                entry.voice[entry.count] = note.voice;
+                entry.channel[entry.count] = note.channel;
+                entry.count++;
+            }
+
+            voice = next;
+        }
+
+        return entry;
+    }
+
+    // Remove the oldest voice, returns false if there are none. The input
+    // is marked, so its release can tell a stolen note from one that was
+    // never played.
+    auto steal(Note &evicted) -> bool {
+        if (!this->remove(this->oldest_, evicted)) {
+            return false;
+        }
+
+        this->stolen_[evicted.input] = true;
+        return true;
+    }
+
+    // Remove a voice, returns false if it is not playing. A key has at most
+    // SLOTS voices so finding it in the key's list is bounded.
+    auto remove(int voice, Note &removed) -> bool {
+        if ((voice < 0) || (voice >= VOICES) || !this->voices_[voice].active) {
+            return false;
+        }
+
+        Voice &slot = this->voices_[voice];
+        int input = slot.note.input;
+        removed = slot.note;
+
+        // Unlink from the key.
+        int16_t previous = NONE;
+
+        for (int16_t other = this->keyHead_[input]; other != voice; other = this->voices_[other].key) {
+            previous = other;
+        }
+
+        if (previous == NONE) {
+            this->keyHead_[input] = slot.key;
+        } else {
+            this->voices_[previous].key = slot.key;
+        }
+
+        if (this->keyTail_[input] == voice) {
+            this->keyTail_[input] = previous;
+        }
+
+        this->counts_[input]--;
+
+        // Unlink from the age list.
+        if (slot.prev == NONE) {
+            this->oldest_ = slot.next;
+        } else {
+            this->voices_[slot.prev].next = slot.next;
+        }
+
+        if (slot.next == NONE) {
+            this->newest_ = slot.prev;
+        } else {
+            this->voices_[slot.next].prev = slot.prev;
+        }
+
+        slot.active = false;
+        slot.next = this->free_;
+        this->free_ = static_cast<int16_t>(voice);
+        this->size_--;
+
+        return true;
+    }
+
+    auto clear() -> void {
+        this->keyHead_.fill(NONE);
+        this->keyTail_.fill(NONE);
+        this->counts_.fill(0);
+        this->stolen_.fill(false);
+
+        for (int voice = 0; voice < VOICES; voice++) {
+            this->voices_[voice].active = false;
+            this->voices_[voice].next = static_cast<int16_t>((voice + 1 < VOICES) ? voice + 1 : NONE);
+        }
+
+        this->free_ = 0;
+        this->oldest_ = NONE;
+        this->newest_ = NONE;
+        this->size_ = 0;
+    }
+
+    // Set the number of voices, the caller steals the voices above the
+    // new limit.
+    auto setPolyphony(int polyphony) -> void { this->polyphony_ = std::clamp(polyphony, 1, static_cast<int>(VOICES)); }
+
+    [[nodiscard]] auto getPolyphony() const -> int { return this->polyphony_; }
+    [[nodiscard]] auto newest() const -> int { return this->newest_; }
+    [[nodiscard]] auto count(int input) const -> int { return this->counts_[input]; }
+    [[nodiscard]] auto size() const -> int { return this->size_; }
+    [[nodiscard]] auto empty() const -> bool { return this->size_ == 0; }
+
+    // All active notes from the oldest to the newest, for inspection.
+    [[nodiscard]] auto notes() const -> std::vector<Note> {
+        std::vector<Note> result;
+
+        for (int16_t voice = this->oldest_; voice != NONE; voice = this->voices_[voice].next) {
+            result.push_back(this->voices_[voice].note);
+        }
+
+        return result;
+    }
+
+private:
+    static constexpr int16_t NONE = -1;
+
+    struct Voice {
+        Note note;
+        int16_t key;  // Next voice of the same input.
+        int16_t prev; // Age list, or the free list in next.
+        int16_t next;
+        bool active;
+    };
+
+    std::array<Voice, VOICES> voices_ = {};
+    std::array<int16_t, MIDI::KEYBOARD_SIZE> keyHead_ = {};
+    std::array<int16_t, MIDI::KEYBOARD_SIZE> keyTail_ = {};
+    std::array<uint8_t, MIDI::KEYBOARD_SIZE> counts_ = {};
+    std::array<bool, MIDI::KEYBOARD_SIZE> stolen_ = {};
+
+    int16_t free_ = 0;
+    int16_t oldest_ = NONE;
+    int16_t newest_ = NONE;
+    int size_ = 0;
+    int polyphony_ = VOICES;
+};
@@ -0,0 +1,257 @@
+/// @file       OctaveDistribution.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include "Utils/MIDI.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Walker's alias method, samples one of N outcomes in constant time.
+template <size_t N> class AliasTable {
+public:
+    // Build the table from the first count weights, returns false if they
+    // are all zero.
+    auto build(const double *weights, size_t count) -> bool {
+        this->size_ = 0;
+        count = std::min(count, N);
+
+        double total = 0.0;
+
+        for (size_t i = 0; i < count; i++) {
+            total += std::max(weights[i], 0.0);
+        }
+
+        if (total <= 0.0) {
+            return false;
+        }
+
+        std::array<double, N> scaled = {};
+        std::array<uint8_t, N> small = {};
+        std::array<uint8_t, N> large = {};
+        size_t smallCount = 0;
+        size_t largeCount = 0;
+
+        for (size_t i = 0; i < count; i++) {
+            scaled[i] = std::max(weights[i], 0.0) * static_cast<double>(count) / total;
+
+            if (scaled[i] < 1.0) {
+                small[smallCount++] = static_cast<uint8_t>(i);
+            } else {
+                large[largeCount++] = static_cast<uint8_t>(i);
+            }
+        }
+
+        while ((smallCount > 0) && (largeCount > 0)) {
+            uint8_t less = small[--smallCount];
+            uint8_t more = large[--largeCount];
+
+            this->threshold_[less] = toThreshold(scaled[less]);
+            this->alias_[less] = more;
+
+            scaled[more] = (scaled[more] + scaled[less]) - 1.0;
+
+            if (scaled[more] < 1.0) {
+                small[smallCount++] = more;
+            } else {
+                large[largeCount++] = more;
+            }
+        }
+
+        // Whatever is left has a probability of one.
+        while (largeCount > 0) {
+            uint8_t index = large[--largeCount];
+            this->threshold_[index] = UINT32_MAX;
+            this->alias_[index] = index;
+        }
+
+        while (smallCount > 0) {
+            uint8_t index = small[--smallCount];
+            this->threshold_[index] = UINT32_MAX;
+            this->alias_[index] = index;
+        }
+
+        this->size_ = static_cast<uint8_t>(count);
+        return true;
+    }
+
+    // Pick an outcome from two uniformly distributed random numbers.
+    [[nodiscard]] auto sample(uint32_t column, uint32_t coin) const -> size_t {
+        auto index = static_cast<size_t>((static_cast<uint64_t>(column) * this->size_) >> 32); // NOLINT
+        return (coin <= this->threshold_[index]) ? index : this->alias_[index];
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return this->size_; }
+
+private:
+    static auto toThreshold(double probability) -> uint32_t {
+        return static_cast<uint32_t>(std::clamp(probability, 0.0, 1.0) * static_cast<double>(UINT32_MAX));
+    }
+
+    std::array<uint32_t, N> threshold_ = {};
+    std::array<uint8_t, N> alias_ = {};
+    uint8_t size_ = 0;
+};
+
+// Per octave weights for the octaves in a note range.
+//
+// The first weight is for the octave of the lowest note in the range, with
+// no weights every octave is equally likely. There is one alias table for
+// each pitch class, holding the octaves where that pitch class is inside
+// the range. The tables are rebuilt when the range or the weights change,
+// picking an octave for a note is constant time.
+//
+// Notes pick while the range and weights are set on another thread. There
+// are two sets of tables, a change is built into the one notes aren't
+// using and then published with one index swap, so a note always samples
+// a whole set. Building waits for notes still picking from the set it
+// reuses, a pick never waits.
+class OctaveDistribution {
+public:
+    enum : uint8_t {
+        OCTAVE_COUNT = (MIDI::KEYBOARD_SIZE + MIDI::OCTAVE - 1) / MIDI::OCTAVE
+    };
+
+    OctaveDistribution() : random_(std::random_device{}()) {}
+
+    OctaveDistribution(const OctaveDistribution &) = delete;
+    auto operator=(const OctaveDistribution &) -> OctaveDistribution & = delete;
+
+    auto setRange(int low, int high) -> void {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->low_ = std::clamp(std::min(low, high), MIDI::RANGE_LOW, MIDI::RANGE_HIGH);
+        this->high_ = std::clamp(std::max(low, high), MIDI::RANGE_LOW, MIDI::RANGE_HIGH);
+        this->rebuild();
+    }
+
+    auto setWeights(const std::vector<double> &weights) -> void {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->weights_ = weights;
+        this->rebuild();
+    }
+
+    auto clearWeights() -> void {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->weights_.clear();
+        this->rebuild();
+    }
+
+    [[nodiscard]] auto isWeighted() const -> bool { return this->sets_[this->current_.load()].weighted; }
+
+    [[nodiscard]] auto low() const -> int {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->low_;
+    }
+
+    [[nodiscard]] auto high() const -> int {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->high_;
+    }
+
+    [[nodiscard]] auto weights() const -> std::vector<double> {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        return this->weights_;
+    }
+
+    // Pick a pitch with the given pitch class, -1 if the pitch class has no
+    // octave in the range.
+    auto pick(int pitchClass) -> int {
+        bool weighted = false;
+        return this->pick(pitchClass, weighted);
+    }
+
+    // The same, weighted tells if the tables picked from have weights.
+    auto pick(int pitchClass, bool &weighted) -> int {
+        uint32_t index = this->current_.load();
+
+        // A set that was swapped out before this pick was counted may be
+        // rebuilt already, pick from the new one instead.
+        for (;;) {
+            this->readers_[index].fetch_add(1);
+            uint32_t current = this->current_.load();
+
+            if (current == index) {
+                break;
+            }
+
+            this->readers_[index].fetch_sub(1);
+            index = current;
+        }
+
+        const Tables &set = this->sets_[index];
+        const auto &table = set.tables[pitchClass];
+        int pitch = -1;
+
+        if (table.size() != 0) {
+            size_t octave = table.sample(this->random_(), this->random_());
+            pitch = (set.octaves[pitchClass][octave] * MIDI::OCTAVE) + pitchClass;
+        }
+
+        weighted = set.weighted;
+        this->readers_[index].fetch_sub(1, std::memory_order_release);
+        return pitch;
+    }
+
+private:
+    struct Tables {
+        std::array<AliasTable<OCTAVE_COUNT>, MIDI::OCTAVE> tables = {};
+        std::array<std::array<uint8_t, OCTAVE_COUNT>, MIDI::OCTAVE> octaves = {};
+        bool weighted = false;
+    };
+
+    // Called with the mutex held.
+    auto rebuild() -> void {
+        uint32_t next = 1 - this->current_.load();
+
+        while (this->readers_[next].load() != 0) {
+            std::this_thread::yield();
+        }
+
+        Tables &set = this->sets_[next];
+        int lowestOctave = this->low_ / MIDI::OCTAVE;
+        bool weighted = !this->weights_.empty();
+
+        for (int pitchClass = 0; pitchClass < MIDI::OCTAVE; pitchClass++) {
+            std::array<double, OCTAVE_COUNT> weights = {};
+            size_t count = 0;
+
+            for (int octave = lowestOctave; octave < OCTAVE_COUNT; octave++) {
+                int pitch = (octave * MIDI::OCTAVE) + pitchClass;
+                auto weightIndex = static_cast<size_t>(octave - lowestOctave);
+
+                if ((pitch < this->low_) || (pitch > this->high_) || (weighted && (weightIndex >= this->weights_.size()))) {
+                    continue;
+                }
+
+                set.octaves[pitchClass][count] = static_cast<uint8_t>(octave);
+                weights[count] = weighted ? this->weights_[weightIndex] : 1.0;
+                count++;
+            }
+
+            set.tables[pitchClass].build(weights.data(), count);
+        }
+
+        set.weighted = weighted;
+        this->current_.store(next);
+    }
+
+    // The range and weights the tables are built from, set under the mutex.
+    mutable std::mutex mutex_;
+    int low_ = MIDI::RANGE_LOW;
+    int high_ = MIDI::RANGE_HIGH;
+    std::vector<double> weights_;
+
+    std::array<Tables, 2> sets_ = {};
+    std::atomic<uint32_t> current_ {0};
+    std::array<std::atomic<uint32_t>, 2> readers_ {};
+    std::mt19937 random_;
+};
@@ -0,0 +1,99 @@
+/// @file       OutletArray.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <c74_min.h>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+
+// A run of outlets whose number is only known when the object is created.
+//
+// Outlets can't be moved once they are registered with their object, so they
+// used to be allocated one by one behind a vector of pointers. Here they are
+// built in place in a single block, one allocation per object and the
+// outlets sit next to each other when an object updates all of them.
+template <typename Outlet = c74::min::outlet<>> class OutletArray {
+public:
+    OutletArray() = default;
+    ~OutletArray() { this->clear(); }
+
+    OutletArray(const OutletArray &) = delete;
+    auto operator=(const OutletArray &) -> OutletArray & = delete;
+
+    // Create count outlets in order, describe(i) gives the description of
+    // outlet i, see OutletNames. Only call this from the object's constructor.
+    template <typename Describe> auto create(c74::min::object_base *owner, int count, Describe &&describe) -> void {
+        this->clear();
+
+        if (count <= 0) {
+            return;
+        }
+
+        this->slots_ = std::make_unique<Slot[]>(count); // NOLINT
+
+        for (int i = 0; i < count; i++) {
+            new (&this->slots_[i]) Outlet(owner, describe(i));
+            this->size_ = static_cast<uint16_t>(i + 1);
+        }
+    }
+
+    auto operator[](size_t index) -> Outlet & {
+        return *std::launder(reinterpret_cast<Outlet *>(&this->slots_[index])); // NOLINT
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return this->size_; }
+    [[nodiscard]] auto empty() const -> bool { return this->size_ == 0; }
+
+    // Heap memory used by the outlets.
+    [[nodiscard]] auto bytes() const -> size_t { return this->size_ * sizeof(Slot); }
+
+private:
+    using Slot = std::aligned_storage_t<sizeof(Outlet), alignof(Outlet)>;
+
+    auto clear() -> void {
+        for (size_t i = this->size_; i > 0; i--) {
+            (*this)[i - 1].~Outlet();
+        }
+
+        this->slots_.reset();
+        this->size_ = 0;
+    }
+
+    std::unique_ptr<Slot[]> slots_; // NOLINT
+    uint16_t size_ = 0;
+};
+
+// Descriptions of numbered outlets, "prefix 0", "prefix 1", ... shared by
+// every object of a class. Each description is formatted the first time an
+// object asks for it, so loading a patch with many objects doesn't format the
+// same strings over and over. Use one as a function static in the
+// constructor and pass it to OutletArray::create().
+class OutletNames {
+public:
+    explicit OutletNames(const char *prefix) : prefix_(prefix) {}
+
+    // The reference stays valid, the names are never moved.
+    auto operator()(int index) -> const std::string & {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        while (static_cast<int>(this->names_.size()) <= index) {
+            this->names_.push_back(this->prefix_ + std::to_string(this->names_.size()));
+        }
+
+        return this->names_[index];
+    }
+
+private:
+    std::string prefix_;
+    std::deque<std::string> names_;
+    std::mutex mutex_;
+};
@@ -0,0 +1,9 @@
+/// @file       SharedTests.cpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+// The test runner for the shared helpers that don't need Max.
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
@@ -0,0 +1,351 @@
+/// @file       StateSnapshot.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <c74_min.h>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// Binary snapshots of an object's state.
+//
+// A snapshot is a header, "SEST" and the version of the object's state,
+// followed by the object's fields as raw bytes in host byte order. A field is
+// a trivially copyable value, or an array of them with a uint32 count in
+// front, so restoring a field is a single copy. An object bumps its version
+// when its fields change and reads older snapshots by their version.
+class StateWriter {
+public:
+    explicit StateWriter(uint16_t version) {
+        this->bytes_.insert(this->bytes_.end(), MAGIC.begin(), MAGIC.end());
+        this->write(version);
+    }
+
+    template <typename T> auto write(const T &value) -> void {
+        static_assert(std::is_trivially_copyable_v<T>, "state fields are copied as bytes");
+        const auto *begin = reinterpret_cast<const uint8_t *>(&value); // NOLINT
+        this->bytes_.insert(this->bytes_.end(), begin, begin + sizeof(T));
+    }
+
+    template <typename T> auto writeArray(const T *values, size_t count) -> void {
+        static_assert(std::is_trivially_copyable_v<T>, "state fields are copied as bytes");
+        this->write(static_cast<uint32_t>(count));
+
+        if (count > 0) {
+            const auto *begin = reinterpret_cast<const uint8_t *>(values); // NOLINT
+            this->bytes_.insert(this->bytes_.end(), begin, begin + (count * sizeof(T)));
+        }
+    }
+
+    auto bytes() -> std::vector<uint8_t> & { return this->bytes_; }
+
+    static constexpr std::array<uint8_t, 4> MAGIC = {'S', 'E', 'S', 'T'};
+
+private:
+    std::vector<uint8_t> bytes_;
+};
+
+// Reads a snapshot back. A read past the end, or from a snapshot without a
+// valid header, fails and leaves the reader invalid, so an object can read
+// all its fields and check once at the end.
+class StateReader {
+public:
+    StateReader(const uint8_t *data, size_t size) : data_(data), size_(size) {
+        this->valid_ = (size >= StateWriter::MAGIC.size()) && (std::memcmp(data, StateWriter::MAGIC.data(), StateWriter::MAGIC.size()) == 0);
+        this->at_ = StateWriter::MAGIC.size();
+        this->read(this->version_);
+    }
+
+    explicit StateReader(const std::vector<uint8_t> &bytes) : StateReader(bytes.data(), bytes.size()) {}
+
+    [[nodiscard]] auto isValid() const -> bool { return this->valid_; }
+    [[nodiscard]] auto version() const -> uint16_t { return this->version_; }
+
+    template <typename T> auto read(T &value) -> bool {
+        static_assert(std::is_trivially_copyable_v<T>, "state fields are copied as bytes");
+
+        if (!this->valid_ || (this->at_ + sizeof(T) > this->size_)) {
+            this->valid_ = false;
+            return false;
+        }
+
+        std::memcpy(&value, this->data_ + this->at_, sizeof(T));
+        this->at_ += sizeof(T);
+        return true;
+    }
+
+    // Reads an array into a fixed block of capacity values. Values past the
+    // capacity are skipped, count is the number of values copied.
+    template <typename T> auto readArray(T *values, size_t capacity, size_t &count) -> bool {
+        size_t stored = 0;
+        const uint8_t *begin = this->arrayBytes(sizeof(T), UINT32_MAX, stored);
+
+        if (!this->valid_) {
+            return false;
+        }
+
+        count = std::min(stored, capacity);
+
+        if (begin != nullptr) {
+            std::memcpy(values, begin, count * sizeof(T));
+        }
+
+        return true;
+    }
+
+    template <typename T> auto readArray(std::vector<T> &values, size_t maxCount) -> bool {
+        size_t count = 0;
+        const uint8_t *begin = this->arrayBytes(sizeof(T), maxCount, count);
+
+        if (!this->valid_) {
+            return false;
+        }
+
+        values.resize(count);
+
+        if (begin != nullptr) {
+            std::memcpy(values.data(), begin, count * sizeof(T));
+        }
+
+        return true;
+    }
+
+private:
+    auto arrayBytes(size_t size, size_t maxCount, size_t &count) -> const uint8_t * {
+        uint32_t stored = 0;
+
+        if (!this->read(stored) || (stored > maxCount) || (this->at_ + (stored * size) > this->size_)) {
+            this->valid_ = false;
+            return nullptr;
+        }
+
+        const uint8_t *begin = this->data_ + this->at_;
+        this->at_ += stored * size;
+        count = stored;
+        return (stored > 0) ? begin : nullptr;
+    }
+
+    const uint8_t *data_;
+    size_t size_;
+    size_t at_ = 0;
+    uint16_t version_ = 0;
+    bool valid_ = false;
+};
+
+// A fixed set of snapshot slots to switch scenes with recall. Finding a slot
+// is an index, a store swaps the new snapshot in and a recall restores from
+// the slot in place.
+//
+// Stores and loads come from the main thread, a recall can come from the
+// scheduler and never waits for them. Each slot points to its snapshot, a
+// store replaces the pointer in one exchange and keeps the old snapshot until
+// no recall is reading, then a later store frees it. A recall counts itself
+// in readers_ before it loads a slot, so once a store sees no readers after
+// its exchange, nothing can still hold the old snapshot.
+template <size_t Count = 16> class StateSlots { // NOLINT
+public:
+    using Snapshot = std::vector<uint8_t>;
+
+    StateSlots() = default;
+
+    ~StateSlots() {
+        for (auto &slot : this->slots_) {
+            delete slot.load(std::memory_order_relaxed);
+        }
+
+        this->reclaim(true);
+    }
+
+    StateSlots(const StateSlots &) = delete;
+    auto operator=(const StateSlots &) -> StateSlots & = delete;
+
+    static auto isValidSlot(int slot) -> bool { return (slot >= 0) && (slot < static_cast<int>(Count)); }
+
+    // Main thread.
+    auto store(int slot, Snapshot snapshot) -> bool {
+        if (!StateSlots::isValidSlot(slot)) {
+            return false;
+        }
+
+        this->replace(slot, new Snapshot(std::move(snapshot)));
+        return true;
+    }
+
+    // Calls restore(StateReader &) with the snapshot in the slot, false when
+    // the slot is empty or the snapshot can't be restored.
+    template <typename Restore> auto recall(int slot, Restore restore) -> bool {
+        if (!StateSlots::isValidSlot(slot)) {
+            return false;
+        }
+
+        this->readers_.fetch_add(1);
+        const Snapshot *snapshot = this->slots_[slot].load();
+        bool restored = false;
+
+        if ((snapshot != nullptr) && !snapshot->empty()) {
+            StateReader reader(*snapshot);
+            restored = restore(reader);
+        }
+
+        this->readers_.fetch_sub(1, std::memory_order_release);
+        return restored;
+    }
+
+    // Every slot, for saving them with the patcher. Main thread, like the
+    // stores, so no slot can be freed while it is written.
+    auto save(StateWriter &writer) const -> void {
+        for (const auto &slot : this->slots_) {
+            const Snapshot *snapshot = slot.load(std::memory_order_acquire);
+
+            if (snapshot == nullptr) {
+                writer.writeArray(static_cast<const uint8_t *>(nullptr), 0);
+            } else {
+                writer.writeArray(snapshot->data(), snapshot->size());
+            }
+        }
+    }
+
+    // Main thread.
+    auto load(StateReader &reader) -> bool {
+        std::array<Snapshot, Count> slots;
+
+        for (auto &slot : slots) {
+            if (!reader.readArray(slot, UINT32_MAX)) {
+                return false;
+            }
+        }
+
+        for (size_t slot = 0; slot < Count; slot++) {
+            this->replace(static_cast<int>(slot), slots[slot].empty() ? nullptr : new Snapshot(std::move(slots[slot])));
+        }
+
+        return true;
+    }
+
+    // Heap bytes of the stored snapshots, any thread.
+    auto bytes() const -> size_t {
+        size_t total = 0;
+
+        this->readers_.fetch_add(1);
+
+        for (const auto &slot : this->slots_) {
+            const Snapshot *snapshot = slot.load();
+            total += (snapshot == nullptr) ? 0 : sizeof(Snapshot) + snapshot->capacity();
+        }
+
+        this->readers_.fetch_sub(1, std::memory_order_release);
+        return total;
+    }
+
+private:
+    auto replace(int slot, const Snapshot *snapshot) -> void {
+        const Snapshot *old = this->slots_[slot].exchange(snapshot);
+
+        if (old != nullptr) {
+            this->retired_.push_back(old);
+        }
+
+        this->reclaim(false);
+    }
+
+    // Free the replaced snapshots once no recall can be reading them.
+    auto reclaim(bool force) -> void {
+        if (!force && (this->readers_.load() != 0)) {
+            return;
+        }
+
+        for (const Snapshot *snapshot : this->retired_) {
+            delete snapshot;
+        }
+
+        this->retired_.clear();
+    }
+
+    std::array<std::atomic<const Snapshot *>, Count> slots_ {};
+    mutable std::atomic<uint32_t> readers_ {0};
+    std::vector<const Snapshot *> retired_;
+};
+
+// Keeping snapshots with the patcher. The current state and the slots are
+// saved under one key of the object's saved state dictionary, four bytes to
+// an int atom so the values survive the patcher file.
+class StateSnapshot {
+public:
+    enum : uint16_t {
+        VERSION = 1
+    };
+
+    template <typename Slots> static auto save(c74::min::dict &state, const std::vector<uint8_t> &current, Slots &slots) -> void {
+        auto *dictionary = static_cast<c74::max::t_dictionary *>(state);
+
+        if (dictionary == nullptr) {
+            return;
+        }
+
+        StateWriter writer(VERSION);
+        writer.writeArray(current.data(), current.size());
+        slots.save(writer);
+
+        const auto &bytes = writer.bytes();
+        c74::min::atoms values;
+        values.reserve(1 + ((bytes.size() + 3) / 4));
+        values.emplace_back(static_cast<long>(bytes.size()));
+
+        for (size_t at = 0; at < bytes.size(); at += 4) {
+            uint32_t word = 0;
+            std::memcpy(&word, bytes.data() + at, std::min<size_t>(4, bytes.size() - at));
+            values.emplace_back(static_cast<long>(word));
+        }
+
+        c74::max::dictionary_appendatoms(dictionary, key(), static_cast<long>(values.size()), values.data());
+    }
+
+    // Restores the current state with restore(StateReader &) and fills the
+    // slots, false when there is no saved state.
+    template <typename Slots, typename Restore> static auto load(c74::min::dict state, Slots &slots, Restore restore) -> bool {
+        auto *dictionary = static_cast<c74::max::t_dictionary *>(state);
+        long count = 0;
+        c74::max::t_atom *values = nullptr;
+
+        if ((dictionary == nullptr) || (c74::max::dictionary_getatoms(dictionary, key(), &count, &values) != 0) || (count < 1)) {
+            return false;
+        }
+
+        auto size = static_cast<size_t>(c74::max::atom_getlong(values));
+
+        if ((size + 3) / 4 != static_cast<size_t>(count - 1)) {
+            return false;
+        }
+
+        std::vector<uint8_t> bytes(size);
+
+        for (size_t at = 0; at < size; at += 4) {
+            auto word = static_cast<uint32_t>(c74::max::atom_getlong(values + 1 + (at / 4))); // NOLINT
+            std::memcpy(bytes.data() + at, &word, std::min<size_t>(4, size - at));
+        }
+
+        StateReader reader(bytes);
+        std::vector<uint8_t> current;
+
+        if (!reader.readArray(current, UINT32_MAX) || !slots.load(reader)) {
+            return false;
+        }
+
+        StateReader currentReader(current);
+        return restore(currentReader);
+    }
+
+private:
+    static auto key() -> c74::max::t_symbol * {
+        static c74::max::t_symbol *key = c74::max::gensym("seidr_state");
+        return key;
+    }
+};
@@ -0,0 +1,135 @@
+/// @file       StressRunner.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Sends messages to an object the way Max does, as fast as they go, to shake
+// out races between its handlers. One thread plays the scheduler and one
+// plays the main thread, there is never more than one of each. The main
+// thread workloads take turns on the main thread. Both threads are released
+// together so they overlap for as long as possible.
+//
+// Only the scheduler thread sends to the outlets. Every DRAIN_EVERY messages
+// it calls the drain, which checks what was sent and empties the outlets, and
+// once more at the end, so a test can count and check every output.
+//
+// Used by the [stress] test cases, which are meant to be run under
+// ThreadSanitizer (SEIDR_TSAN) to catch the races, not only the crashes.
+class StressRunner {
+public:
+    enum : uint16_t {
+        DRAIN_EVERY = 1024
+    };
+
+    struct Result {
+        std::string name;
+        uint64_t operations = 0;
+        double seconds = 0.0;
+    };
+
+    using Work = std::function<void(uint64_t)>;
+
+    explicit StressRunner(uint64_t operations) : operations_(operations) {}
+
+    auto scheduler(const std::string &name, Work work, std::function<void()> drain) -> void {
+        this->scheduler_ = {name, std::move(work)};
+        this->drain_ = std::move(drain);
+    }
+
+    auto main(const std::string &name, Work work) -> void {
+        this->main_.push_back({name, std::move(work)});
+    }
+
+    auto run() -> std::vector<Result> {
+        std::vector<Result> results(2);
+        std::vector<std::thread> threads;
+        std::atomic<size_t> ready {0};
+        std::atomic<bool> go {false};
+
+        std::array<Work, 2> work = {
+            [this](uint64_t n) {
+                this->scheduler_.work(n);
+
+                if ((n % DRAIN_EVERY == DRAIN_EVERY - 1) || (n + 1 == this->operations_)) {
+                    this->drain_();
+                }
+            },
+            [this](uint64_t n) {
+                for (auto &workload : this->main_) {
+                    workload.work(n);
+                }
+            }};
+
+        results[0].name = "scheduler: " + this->scheduler_.name;
+        results[1].name = "main:";
+
+        for (const auto &workload : this->main_) {
+            results[1].name += " " + workload.name;
+        }
+
+        for (size_t i = 0; i < work.size(); i++) {
+            threads.emplace_back([&, i] {
+                ready.fetch_add(1, std::memory_order_acq_rel);
+
+                while (!go.load(std::memory_order_acquire)) {
+                    std::this_thread::yield();
+                }
+
+                auto start = std::chrono::steady_clock::now();
+
+                for (uint64_t n = 0; n < this->operations_; n++) {
+                    work[i](n);
+                }
+
+                auto elapsed = std::chrono::steady_clock::now() - start;
+                results[i].operations = this->operations_;
+                results[i].seconds = std::chrono::duration<double>(elapsed).count();
+            });
+        }
+
+        while (ready.load(std::memory_order_acquire) < threads.size()) {
+            std::this_thread::yield();
+        }
+
+        go.store(true, std::memory_order_release);
+
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        return results;
+    }
+
+    static auto report(const std::string &object, const std::vector<Result> &results, std::ostream &stream) -> void {
+        stream << object << " under contention:\n";
+
+        for (const auto &result : results) {
+            double rate = (result.seconds > 0.0) ? static_cast<double>(result.operations) / result.seconds : 0.0;
+            stream << "  " << result.name << ": " << static_cast<uint64_t>(rate) << " messages/s\n";
+        }
+    }
+
+private:
+    struct Workload {
+        std::string name;
+        Work work;
+    };
+
+    uint64_t operations_;
+    Workload scheduler_;
+    std::function<void()> drain_;
+    std::vector<Workload> main_;
+};
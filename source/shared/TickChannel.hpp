@@ -0,0 +1,297 @@
+/// @file       TickChannel.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <c74_min.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// Clock ticks from seidr.Clock~ to the objects that follow it.
+//
+// The clock runs on the audio thread and sends every tick through a named
+// channel. Each follower has an inbox, a single producer single consumer
+// ring, so the audio thread never locks or allocates. The first tick in an
+// empty inbox wakes the follower, which steps once for every tick on the
+// scheduler. A tick carries its sample position, so the steps are in lock
+// step with the audio and every output can be placed on its sample.
+struct Tick {
+    uint64_t sample = 0; // Samples since the clock started.
+    uint32_t index = 0;  // Ticks since the clock started or was reset.
+    uint16_t offset = 0; // Position in the signal vector.
+};
+
+class TickInbox {
+public:
+    enum : uint32_t {
+        CAPACITY = 256 // Power of two.
+    };
+
+    // Called on the audio thread when a tick lands in the inbox and the
+    // follower isn't already woken, it must not block.
+    explicit TickInbox(std::function<void()> wake) : wake_(std::move(wake)) {}
+
+    // Audio thread. A tick that doesn't fit is dropped and counted.
+    auto push(const Tick &tick) -> bool {
+        uint32_t head = this->head_.load(std::memory_order_relaxed);
+
+        if (head - this->tail_.load(std::memory_order_acquire) >= CAPACITY) {
+            this->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        this->ticks_[head % CAPACITY] = tick;
+        this->head_.store(head + 1, std::memory_order_release);
+
+        if (!this->woken_.exchange(true, std::memory_order_acq_rel) && this->wake_) {
+            this->wake_();
+        }
+
+        return true;
+    }
+
+    // Follower thread, calls onTick(const Tick &) for every tick in order.
+    template <typename OnTick> auto drain(OnTick onTick) -> int {
+        // Ticks pushed from here on wake the follower again.
+        this->woken_.store(false, std::memory_order_release);
+
+        uint32_t tail = this->tail_.load(std::memory_order_relaxed);
+        uint32_t head = this->head_.load(std::memory_order_acquire);
+        int count = 0;
+
+        for (; tail != head; tail++, count++) {
+            onTick(this->ticks_[tail % CAPACITY]);
+            this->tail_.store(tail + 1, std::memory_order_release);
+        }
+
+        return count;
+    }
+
+    [[nodiscard]] auto dropped() const -> uint64_t { return this->dropped_.load(std::memory_order_relaxed); }
+
+private:
+    std::array<Tick, CAPACITY> ticks_ = {};
+    std::atomic<uint32_t> head_ {0};
+    std::atomic<uint32_t> tail_ {0};
+    std::atomic<bool> woken_ {false};
+    std::atomic<uint64_t> dropped_ {0};
+    std::function<void()> wake_;
+};
+
+class TickChannel {
+public:
+    enum : uint8_t {
+        MAX_FOLLOWERS = 64
+    };
+
+    // The channel with this name, made the first time it is asked for and
+    // shared while anything holds it.
+    static auto named(const std::string &name) -> std::shared_ptr<TickChannel> {
+        Registry &registry = Registry::shared();
+
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto &entry = registry.channels[name];
+        auto channel = entry.lock();
+
+        if (!channel) {
+            channel = std::make_shared<TickChannel>();
+            entry = channel;
+        }
+
+        return channel;
+    }
+
+    // Only one clock can send on a channel, the inboxes have one producer.
+    auto claim() -> bool { return !this->claimed_.exchange(true, std::memory_order_acq_rel); }
+    auto release() -> void { this->claimed_.store(false, std::memory_order_release); }
+
+    auto add(TickInbox *inbox) -> bool {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (auto &slot : this->inboxes_) {
+            if (slot.load() == nullptr) {
+                slot.store(inbox);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Waits for a send in progress, the inbox is never used after this.
+    auto remove(TickInbox *inbox) -> void {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (auto &slot : this->inboxes_) {
+            if (slot.load() == inbox) {
+                slot.store(nullptr);
+            }
+        }
+
+        while (this->sending_.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    // Audio thread.
+    auto send(const Tick &tick) -> void {
+        this->sending_.fetch_add(1);
+
+        for (auto &slot : this->inboxes_) {
+            if (TickInbox *inbox = slot.load()) {
+                inbox->push(tick);
+            }
+        }
+
+        this->sending_.fetch_sub(1);
+    }
+
+private:
+    // Every external is a binary of its own with its own statics, so the
+    // names are kept in Max, on a symbol they all see, and a clock in one
+    // can be followed from the others. The symbol's name carries a version,
+    // bump it when the layout of the registry or the channel changes.
+    struct Registry {
+        std::mutex mutex;
+        std::map<std::string, std::weak_ptr<TickChannel>> channels;
+
+        // Made on the main thread, where the names are set.
+        static auto shared() -> Registry & {
+            c74::max::t_symbol *key = c74::max::gensym("#seidr.tickchannels.1");
+
+            if (key->s_thing == nullptr) {
+                key->s_thing = reinterpret_cast<c74::max::t_object *>(new Registry); // NOLINT
+            }
+
+            return *reinterpret_cast<Registry *>(key->s_thing); // NOLINT
+        }
+    };
+
+    std::array<std::atomic<TickInbox *>, MAX_FOLLOWERS> inboxes_ = {};
+    std::atomic<uint32_t> sending_ {0};
+    std::atomic<bool> claimed_ {false};
+    std::mutex mutex_;
+};
+
+// The clock's side of a channel. The name is set from the main thread while
+// the audio thread sends, a name change waits for a send in progress before
+// the old channel is let go.
+class TickSender {
+public:
+    TickSender() = default;
+    ~TickSender() { this->setName(""); }
+
+    TickSender(const TickSender &) = delete;
+    auto operator=(const TickSender &) -> TickSender & = delete;
+
+    // Empty sends nowhere. False when another clock sends on the channel,
+    // the sender then keeps the channel and name it had.
+    auto setName(const std::string &name) -> bool {
+        if (this->channel_ && (name == this->name_)) {
+            return true;
+        }
+
+        std::shared_ptr<TickChannel> channel;
+
+        if (!name.empty()) {
+            channel = TickChannel::named(name);
+
+            if (!channel->claim()) {
+                return false;
+            }
+        }
+
+        this->active_.store(channel.get());
+
+        while (this->sending_.load() != 0) {
+            std::this_thread::yield();
+        }
+
+        if (this->channel_) {
+            this->channel_->release();
+        }
+
+        this->channel_ = std::move(channel);
+        this->name_ = name;
+        return true;
+    }
+
+    [[nodiscard]] auto name() const -> const std::string & { return this->name_; }
+
+    // Audio thread.
+    auto send(const Tick &tick) -> void {
+        this->sending_.fetch_add(1);
+
+        if (TickChannel *channel = this->active_.load()) {
+            channel->send(tick);
+        }
+
+        this->sending_.fetch_sub(1);
+    }
+
+private:
+    std::string name_;
+    std::shared_ptr<TickChannel> channel_;
+    std::atomic<TickChannel *> active_ {nullptr};
+    std::atomic<uint32_t> sending_ {0};
+};
+
+// A follower's side of a channel.
+class TickFollower {
+public:
+    explicit TickFollower(std::function<void()> wake) : inbox_(std::move(wake)) {}
+    ~TickFollower() { this->follow(""); }
+
+    TickFollower(const TickFollower &) = delete;
+    auto operator=(const TickFollower &) -> TickFollower & = delete;
+
+    // Empty stops following. False when the channel has no room.
+    auto follow(const std::string &name) -> bool {
+        if (this->channel_) {
+            this->channel_->remove(&this->inbox_);
+            this->channel_.reset();
+        }
+
+        if (name.empty()) {
+            return true;
+        }
+
+        auto channel = TickChannel::named(name);
+
+        if (!channel->add(&this->inbox_)) {
+            return false;
+        }
+
+        this->channel_ = std::move(channel);
+        return true;
+    }
+
+    [[nodiscard]] auto isFollowing() const -> bool { return this->channel_ != nullptr; }
+
+    template <typename OnTick> auto drain(OnTick onTick) -> int {
+        return this->inbox_.drain([this, &onTick](const Tick &tick) {
+            this->last_ = tick;
+            onTick(tick);
+        });
+    }
+
+    // The last tick stepped, its sample position is the time of the outputs.
+    [[nodiscard]] auto lastTick() const -> const Tick & { return this->last_; }
+    [[nodiscard]] auto dropped() const -> uint64_t { return this->inbox_.dropped(); }
+
+private:
+    TickInbox inbox_;
+    std::shared_ptr<TickChannel> channel_;
+    Tick last_;
+};
@@ -0,0 +1,236 @@
+/// @file       TimerWheel.hpp
+///	@ingroup 	seidr
+///	@copyright	Copyright 2025 - Jóhann Berentsson. All rights reserved.
+///	@license	Use of this source code is governed by the MIT License
+///             found in the License.md file.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// A two level timer wheel for N timers with a resolution of one tick.
+//
+// The first level has a slot for each of the next 256 ticks and the second
+// level a slot for each of the next 256 blocks of 256 ticks. Timers further
+// away than that are clamped to the last tick the wheel can hold. Timers
+// are identified by an index below N and linked into their slot, so
+// scheduling and cancelling a timer is constant time. Each level has a bit
+// per slot that is set while the slot holds timers, so the first timer due
+// is found from the next occupied slots instead of from every timer.
+template <int N> class TimerWheel {
+public:
+    enum : uint32_t {
+        SLOTS = 256,
+        SPAN = SLOTS * SLOTS
+    };
+
+    TimerWheel() { this->clear(); }
+
+    // Schedule a timer delay ticks after the current tick, a timer that is
+    // already scheduled is moved.
+    auto schedule(int timer, uint32_t delay) -> void {
+        this->cancel(timer);
+
+        delay = (delay < 1) ? 1 : ((delay >= SPAN) ? SPAN - 1 : delay);
+
+        this->due_[timer] = this->now_ + delay;
+        this->place(timer);
+        this->size_++;
+    }
+
+    auto cancel(int timer) -> void {
+        int16_t slot = this->slot_[timer];
+
+        if (slot == NONE) {
+            return;
+        }
+
+        if (this->prev_[timer] == NONE) {
+            this->heads_[slot] = this->next_[timer];
+        } else {
+            this->next_[this->prev_[timer]] = this->next_[timer];
+        }
+
+        if (this->next_[timer] != NONE) {
+            this->prev_[this->next_[timer]] = this->prev_[timer];
+        }
+
+        if (this->heads_[slot] == NONE) {
+            this->setOccupied(slot, false);
+        }
+
+        this->slot_[timer] = NONE;
+        this->size_--;
+    }
+
+    // Move the wheel forward to now and call expired with every timer that
+    // is due on the way.
+    template <typename Callback> auto advance(uint32_t now, Callback &&expired) -> void {
+        // Nothing can be missed, jump straight there.
+        if (this->size_ == 0) {
+            this->now_ = now;
+            return;
+        }
+
+        while ((this->now_ != now) && (this->size_ > 0)) {
+            this->now_++;
+
+            // Move the next block down to the first level.
+            if ((this->now_ % SLOTS) == 0) {
+                auto slot = static_cast<int16_t>(SLOTS + ((this->now_ / SLOTS) % SLOTS));
+                int16_t timer = this->heads_[slot];
+                this->heads_[slot] = NONE;
+                this->setOccupied(slot, false);
+
+                while (timer != NONE) {
+                    int16_t next = this->next_[timer];
+                    this->place(timer);
+                    timer = next;
+                }
+            }
+
+            // Unlink each timer before the callback, it may schedule again.
+            auto slot = static_cast<int16_t>(this->now_ % SLOTS);
+
+            while (this->heads_[slot] != NONE) {
+                int16_t timer = this->heads_[slot];
+                this->cancel(timer);
+                expired(timer);
+            }
+        }
+
+        this->now_ = now;
+    }
+
+    auto clear() -> void {
+        this->heads_.fill(NONE);
+        this->slot_.fill(NONE);
+        this->occupied_.fill(0);
+        this->size_ = 0;
+    }
+
+    // Ticks from the current tick until the first timer is due, 0 when none
+    // are scheduled.
+    //
+    // A first level slot holds the timers due on one of the next 255 ticks,
+    // so the first occupied one after the current tick gives its delay. A
+    // second level slot holds a block of 256 ticks that starts after the
+    // current block, only the timers of the first occupied block are looked
+    // through, and only when that block starts before the first level
+    // timer is due.
+    [[nodiscard]] auto nextDue() const -> uint32_t {
+        if (this->size_ == 0) {
+            return 0;
+        }
+
+        uint32_t next = this->distanceToOccupied(0, (this->now_ + 1) % SLOTS);
+        next = (next < SLOTS) ? next + 1 : 0;
+
+        uint32_t block = (this->now_ / SLOTS) + 1;
+        uint32_t blocks = this->distanceToOccupied(1, block % SLOTS);
+
+        if (blocks == SLOTS) {
+            return next;
+        }
+
+        uint32_t start = ((block + blocks) * SLOTS) - this->now_;
+
+        if ((next != 0) && (next <= start)) {
+            return next;
+        }
+
+        for (int16_t timer = this->heads_[SLOTS + ((block + blocks) % SLOTS)]; timer != NONE; timer = this->next_[timer]) {
+            uint32_t delay = this->due_[timer] - this->now_;
+            next = ((next == 0) || (delay < next)) ? delay : next;
+        }
+
+        return next;
+    }
+
+    [[nodiscard]] auto isScheduled(int timer) const -> bool { return this->slot_[timer] != NONE; }
+    [[nodiscard]] auto size() const -> int { return this->size_; }
+    [[nodiscard]] auto empty() const -> bool { return this->size_ == 0; }
+
+private:
+    static constexpr int16_t NONE = -1;
+
+    auto place(int timer) -> void {
+        uint32_t delta = this->due_[timer] - this->now_;
+        uint32_t slot = (delta < SLOTS) ? (this->due_[timer] % SLOTS) : (SLOTS + ((this->due_[timer] / SLOTS) % SLOTS));
+
+        this->slot_[timer] = static_cast<int16_t>(slot);
+        this->setOccupied(slot, true);
+        this->prev_[timer] = NONE;
+        this->next_[timer] = this->heads_[slot];
+
+        if (this->heads_[slot] != NONE) {
+            this->prev_[this->heads_[slot]] = static_cast<int16_t>(timer);
+        }
+
+        this->heads_[slot] = static_cast<int16_t>(timer);
+    }
+
+    auto setOccupied(uint32_t slot, bool occupied) -> void {
+        uint64_t bit = uint64_t {1} << (slot % WORD_BITS);
+        uint64_t &word = this->occupied_[slot / WORD_BITS];
+        word = occupied ? (word | bit) : (word & ~bit);
+    }
+
+    // Slots from slot from of a level to its first occupied slot, going
+    // round once, SLOTS when the level is empty.
+    [[nodiscard]] auto distanceToOccupied(int level, uint32_t from) const -> uint32_t {
+        const uint64_t *words = &this->occupied_[level * WORDS];
+        uint32_t first = from / WORD_BITS;
+        uint64_t below = (uint64_t {1} << (from % WORD_BITS)) - 1;
+
+        // The word holding from is looked at twice, once for the slots from
+        // from on and once at the end of the round for the slots before.
+        for (uint32_t i = 0; i <= WORDS; i++) {
+            uint32_t word = (first + i) % WORDS;
+            uint64_t bits = words[word];
+
+            if (i == 0) {
+                bits &= ~below;
+            } else if (i == WORDS) {
+                bits &= below;
+            }
+
+            if (bits != 0) {
+                uint32_t slot = (word * WORD_BITS) + lowestBit(bits);
+                return (slot + SLOTS - from) % SLOTS;
+            }
+        }
+
+        return SLOTS;
+    }
+
+    static auto lowestBit(uint64_t bits) -> uint32_t {
+#ifdef _MSC_VER
+        unsigned long index = 0;
+        _BitScanForward64(&index, bits);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(bits));
+#endif
+    }
+
+    enum : uint32_t {
+        WORD_BITS = 64,
+        WORDS = SLOTS / WORD_BITS
+    };
+
+    std::array<int16_t, 2 * SLOTS> heads_ = {};
+    std::array<uint64_t, 2 * WORDS> occupied_ = {};
+    std::array<uint32_t, N> due_ = {};
+    std::array<int16_t, N> slot_ = {};
+    std::array<int16_t, N> prev_ = {};
+    std::array<int16_t, N> next_ = {};
+
+    uint32_t now_ = 0;
+    int size_ = 0;
+};